@@ -94,6 +94,32 @@ static inline int atomic_int_compare_and_exchange(volatile int *atomic,
     return result;
 }
 
+static inline void* atomic_pointer_exchange(void* volatile *atomic,
+        void *newval) {
+
+    void *result;
+
+    __asm__ __volatile__("xchg %0, %1"
+            : "=r" (result), "=m" (*atomic)
+            : "0" (newval), "m" (*atomic)
+            : "memory");
+
+    return result;
+}
+
+static inline void* atomic_pointer_compare_and_exchange(void* volatile *atomic,
+        void *oldval, void *newval) {
+
+    void *result;
+
+    __asm__ __volatile__("lock; cmpxchg %2, %1"
+            : "=a" (result), "=m" (*atomic)
+            : "r" (newval), "m" (*atomic), "0" (oldval)
+            : "memory");
+
+    return result;
+}
+
 #endif /* defined __i386__ || defined __x86_64__ */
 
 #endif	/* _ARCH_H_ */
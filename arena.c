@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include "arena.h"
+#include "arch.h"
+
+/**
+ * lock_arena() locks the free units and the reservation of an arena.
+ */
+static inline void lock_arena(arena_t *arena) {
+#ifdef SCM_PRINT_BLOCKING
+    if (pthread_mutex_trylock(&arena->lock)) {
+        printf("Thread %p BLOCKS on arena lock.\n", (void*) pthread_self());
+        pthread_mutex_lock(&arena->lock);
+    }
+#else
+    pthread_mutex_lock(&arena->lock);
+#endif
+}
+
+/**
+ * unlock_arena() releases the lock of an arena.
+ */
+static inline void unlock_arena(arena_t *arena) {
+    pthread_mutex_unlock(&arena->lock);
+}
+
+/**
+ * Reserves the address space of the arena unless this already happened.
+ * The reservation is larger than the arena by one unit, which leaves room
+ * for aligning the first unit.
+ */
+static void reserve_arena(arena_t *arena) {
+    lock_arena(arena);
+
+    if (arena->end == NULL) {
+        void *reservation = mmap(NULL, arena->size + arena->unit_size,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                 -1, 0);
+
+        if (reservation != MAP_FAILED) {
+            unsigned long start = ((unsigned long) reservation
+                + arena->unit_size - 1) & ~(unsigned long) (arena->unit_size - 1);
+
+            arena->end = (void*) start + arena->size;
+            arena->start = (void*) start;
+        } else {
+#ifdef SCM_DEBUG
+            printf("Reservation of arena failed.\n");
+#endif
+        }
+    }
+
+    unlock_arena(arena);
+}
+
+void* arena_alloc(arena_t *arena) {
+    //unsynchronized read, freed units are found at the next allocation
+    if (arena->free_units != NULL) {
+        lock_arena(arena);
+
+        void *unit = arena->free_units;
+
+        if (unit != NULL) {
+            arena->free_units = *(void**) unit;
+        }
+
+        unlock_arena(arena);
+
+        if (unit != NULL) {
+            return unit;
+        }
+    }
+
+    if (arena->end == NULL) {
+        reserve_arena(arena);
+
+        if (arena->end == NULL) {
+            return NULL;
+        }
+    }
+
+    unsigned long max_units = arena->size / arena->unit_size;
+
+    //keeps number_of_units from overflowing once the arena is exhausted
+    if ((unsigned long) arena->number_of_units >= max_units) {
+        return NULL;
+    }
+
+    int index = atomic_int_exchange_and_add(&arena->number_of_units, 1);
+
+    if ((unsigned long) index >= max_units) {
+#ifdef SCM_DEBUG
+        printf("Arena exhausted.\n");
+#endif
+        return NULL;
+    }
+
+    return arena->start + (unsigned long) index * arena->unit_size;
+}
+
+void arena_free(arena_t *arena, void *unit) {
+    lock_arena(arena);
+
+    *(void**) unit = arena->free_units;
+    arena->free_units = unit;
+
+    unlock_arena(arena);
+}
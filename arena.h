@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _ARENA_H_
+#define	_ARENA_H_
+
+#include <stddef.h>
+#include <pthread.h>
+
+/*
+ * An arena is a range of reserved address space that is carved into
+ * units of unit_size bytes, each aligned to unit_size. Since all units are
+ * located between start and end, the arena can tell whether an address
+ * belongs to one of its units and the unit is found by masking the address.
+ *
+ * The address space is reserved when the first unit is allocated. Pages
+ * of the arena are only backed by memory once units are handed out.
+ * Freed units are kept in a list of free units for re-use.
+ */
+typedef struct arena arena_t;
+
+struct arena {
+    // Until the arena is reserved, no address lies between start and end.
+    // The bounds are set one after the other, which keeps every
+    // intermediate state empty as well.
+    void* start;
+    void* end;
+
+    size_t size;
+    size_t unit_size;
+
+    // the number of units handed out from the arena so far
+    int number_of_units;
+
+    // free units are linked through their first word
+    void* free_units;
+
+    // protects free_units and the reservation of the arena
+    pthread_mutex_t lock;
+};
+
+#define ARENA_INITIALIZER(_size, _unit_size) \
+    { (void*) ~0UL, NULL, (_size), (_unit_size), 0, NULL, \
+      PTHREAD_MUTEX_INITIALIZER }
+
+// the unit of an arena with unit size _unit_size that contains _ptr
+#define ARENA_UNIT_OF(_ptr, _unit_size) \
+    ((void*) ((unsigned long) (_ptr) & ~(unsigned long) ((_unit_size) - 1)))
+
+/*
+ * arena_contains() returns true iff ptr points into a unit of the arena.
+ */
+static inline int arena_contains(arena_t *arena, const void *ptr) {
+    return ptr >= arena->start && ptr < arena->end;
+}
+
+/*
+ * arena_alloc() returns a free unit or a fresh unit of the arena, or NULL if
+ * the arena is exhausted or could not be reserved.
+ */
+void* arena_alloc(arena_t *arena)
+    __attribute__((visibility("hidden")));
+
+/*
+ * arena_free() returns a unit to the list of free units of the arena.
+ */
+void arena_free(arena_t *arena, void *unit)
+    __attribute__((visibility("hidden")));
+
+#endif	/* _ARENA_H_ */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+/*
+ * align.c -- measures how the payload alignment of short-term memory
+ * objects affects a vectorized consumer. Every round allocates vectors
+ * of floats either with scm_malloc (STM) or in a region (STR), sums them
+ * up with SSE loads and expires them.
+ *
+ * Compile-time flags:
+ *  STM_MALLOC      allocate vectors with scm_malloc and scm_refresh
+ *  STR_MALLOC      allocate vectors with scm_malloc_in_region
+ *  VECTOR_LENGTH   number of floats per vector
+ *  VECTORS         number of vectors per round
+ *  ROUNDS          number of rounds
+ *  PASSES          number of summations per vector and round
+ *
+ * The SCM_OBJECT_ALIGNMENT and SCM_REGION_OBJECT_ALIGNMENT flags of the
+ * library must be passed, too. When they guarantee 16-byte aligned
+ * vectors, the vectors are summed up with aligned loads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <xmmintrin.h>
+
+#include "libscm.h"
+
+#ifndef VECTOR_LENGTH
+#define VECTOR_LENGTH 30
+#endif
+
+#ifndef VECTORS
+#define VECTORS 1024
+#endif
+
+#ifndef ROUNDS
+#define ROUNDS 1000
+#endif
+
+#ifndef PASSES
+#define PASSES 16
+#endif
+
+#ifdef STR_MALLOC
+#define VECTOR_ALIGNMENT SCM_REGION_OBJECT_ALIGNMENT
+#else
+#define VECTOR_ALIGNMENT SCM_OBJECT_ALIGNMENT
+#endif
+
+#if VECTOR_ALIGNMENT >= 16
+#define LOAD_VECTOR _mm_load_ps
+#else
+#define LOAD_VECTOR _mm_loadu_ps
+#endif
+
+static float* vectors[VECTORS];
+
+static float sum_vector(const float *vector) {
+    __m128 sum = _mm_setzero_ps();
+    float result[4];
+    int i;
+
+    for (i = 0; i + 4 <= VECTOR_LENGTH; i += 4) {
+        sum = _mm_add_ps(sum, LOAD_VECTOR(vector + i));
+    }
+
+    _mm_storeu_ps(result, sum);
+
+    for (; i < VECTOR_LENGTH; i++) {
+        result[0] += vector[i];
+    }
+
+    return result[0] + result[1] + result[2] + result[3];
+}
+
+int main(int argc, char** argv) {
+    struct timespec start, end;
+    unsigned long aligned = 0;
+    unsigned long split_loads = 0;
+    float total = 0;
+    int round, i, j, pass;
+
+#ifdef STR_MALLOC
+    const int region = scm_create_region();
+#endif
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (round = 0; round < ROUNDS; round++) {
+        for (i = 0; i < VECTORS; i++) {
+#ifdef STR_MALLOC
+            vectors[i] = scm_malloc_in_region(VECTOR_LENGTH * sizeof(float),
+                                              region);
+#else
+            vectors[i] = scm_malloc(VECTOR_LENGTH * sizeof(float));
+            scm_refresh(vectors[i], 0);
+#endif
+            for (j = 0; j < VECTOR_LENGTH; j++) {
+                vectors[i][j] = (float) j;
+            }
+
+            if (((unsigned long) vectors[i] & 15) == 0) {
+                aligned++;
+            }
+
+            for (j = 0; j + 4 <= VECTOR_LENGTH; j += 4) {
+                unsigned long offset = (unsigned long) (vectors[i] + j) & 63;
+
+                if (offset > 64 - 4 * sizeof(float)) {
+                    split_loads++;
+                }
+            }
+        }
+
+        for (pass = 0; pass < PASSES; pass++) {
+            for (i = 0; i < VECTORS; i++) {
+                total += sum_vector(vectors[i]);
+            }
+        }
+
+#ifdef STR_MALLOC
+        scm_refresh_region(region, 0);
+#endif
+        scm_tick();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+#ifdef STR_MALLOC
+    scm_unregister_region(region);
+#endif
+
+    printf("aligned %lu%%\n", aligned * 100 / ((unsigned long) ROUNDS * VECTORS));
+    printf("split loads %lu%%\n", split_loads * 100 /
+        ((unsigned long) ROUNDS * VECTORS * (VECTOR_LENGTH / 4)));
+    printf("checksum %.0f\n", total);
+    printf("elapsed_us %ld\n", (end.tv_sec - start.tv_sec) * 1000000L
+        + (end.tv_nsec - start.tv_nsec) / 1000);
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+export LD_LIBRARY_PATH=../../dist/
+
+LOOPRUN=5
+ALLOCATOR=( STM STR )
+ALIGNMENT=( "-DSCM_OBJECT_ALIGNMENT=8" "-DSCM_OBJECT_ALIGNMENT=16" "-DSCM_OBJECT_ALIGNMENT=16 -DSCM_REGION_OBJECT_ALIGNMENT=64" )
+
+mkdir -p bench_results;
+
+for o in "${ALIGNMENT[@]}"
+do
+	echo "";
+	echo "-------------------- $o --------------------";
+	echo "";
+
+	cd ../../; make clean; make SCM="$o" > bench/align/buildlog.txt; cd -;
+	if test -f ../../dist/libscm.so; then
+
+		make clean
+		make BENCH_OPTION="$o" > buildlog.txt
+		for a in ${ALLOCATOR[@]}
+		do
+			if test -f dist/align${a}; then
+				name=$(echo "$o" | tr -d ' ' | tr '=' '_')
+				echo "Started measurement of $a with $o";
+				./dist/align$a | grep -E "aligned|split";
+				echo "" > bench_results/elapsed_us_${a}${name}.dat;
+				sum=0
+				for ((i=1;i<=$LOOPRUN;i++))
+				do
+					elapsed=$(./dist/align$a | sed -n 's/elapsed_us //p');
+					sum=$(( $sum + $elapsed ));
+					echo "$elapsed" >> bench_results/elapsed_us_${a}${name}.dat;
+				done
+				avg=$(( $sum / $LOOPRUN ));
+				echo "AVG total execution time: $avg";
+				echo "---" >> bench_results/elapsed_us_${a}${name}.dat;
+				echo "$avg" >> bench_results/elapsed_us_${a}${name}.dat;
+			else
+				echo "Build of align${a} failed";
+				exit
+			fi
+		done
+	else
+		echo "Build of libscm.so failed";
+		exit
+	fi
+done
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+//MADV_HUGEPAGE is a GNU extension
+#define _GNU_SOURCE
+
+#include <sys/mman.h>
+
+#include "scm.h"
+
+#ifdef SCM_PAGE_CHUNKS
+
+#if (SCM_PAGE_CHUNK_SIZE & (SCM_PAGE_CHUNK_SIZE - 1)) != 0
+#error "SCM_PAGE_CHUNK_SIZE must be a power of two"
+#endif
+
+/**
+ * Maps a chunk aligned to SCM_PAGE_CHUNK_SIZE by over-allocating the mapping
+ * and unmapping the unaligned ends. Returns NULL if the mapping failed.
+ */
+static page_chunk_t* map_chunk() {
+    void *mapping = mmap(NULL, 2 * SCM_PAGE_CHUNK_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (mapping == MAP_FAILED) {
+#ifdef SCM_DEBUG
+        printf("Page chunk could not be mapped.\n");
+#endif
+        return NULL;
+    }
+
+    void *chunk = (void*) ROUND_UP((unsigned long) mapping,
+                                   (unsigned long) SCM_PAGE_CHUNK_SIZE);
+    void *end_of_mapping = mapping + 2 * SCM_PAGE_CHUNK_SIZE;
+
+    if (chunk > mapping) {
+        munmap(mapping, chunk - mapping);
+    }
+    if (chunk + SCM_PAGE_CHUNK_SIZE < end_of_mapping) {
+        munmap(chunk + SCM_PAGE_CHUNK_SIZE,
+               end_of_mapping - (chunk + SCM_PAGE_CHUNK_SIZE));
+    }
+
+#if defined(SCM_PAGE_CHUNK_HUGE_PAGES) && defined(MADV_HUGEPAGE)
+    //only a hint, chunks are still usable without huge pages
+    madvise(chunk, SCM_PAGE_CHUNK_SIZE, MADV_HUGEPAGE);
+#endif
+
+    return chunk;
+}
+
+/**
+ * Drops a reference to the chunk and unmaps it if it was the last one.
+ */
+static inline void release_chunk(page_chunk_t *chunk) {
+    if (atomic_int_dec_and_test((int*) &chunk->number_of_pages)) {
+        munmap(chunk, SCM_PAGE_CHUNK_SIZE);
+    }
+}
+
+void* chunk_alloc_page(page_chunk_allocator_t *allocator, size_t size) {
+    size_t page_size = ROUND_UP(size, PAGE_CHUNK_ALIGNMENT);
+
+    if (page_size > PAGE_CHUNK_MAX_PAGE_SIZE) {
+        return NULL;
+    }
+
+    if (allocator->next_free_address + page_size
+            > allocator->last_address_in_chunk) {
+        page_chunk_t *chunk = map_chunk();
+
+        if (chunk == NULL) {
+            return NULL;
+        }
+
+        //the reference of the allocator keeps the chunk mapped
+        chunk->number_of_pages = 1;
+
+        if (allocator->current != NULL) {
+            release_chunk(allocator->current);
+        }
+
+        allocator->current = chunk;
+        allocator->next_free_address = (void*) chunk + PAGE_CHUNK_HEADER_SIZE;
+        allocator->last_address_in_chunk = (void*) chunk + SCM_PAGE_CHUNK_SIZE;
+    }
+
+    void *page = allocator->next_free_address;
+    allocator->next_free_address += page_size;
+
+    atomic_int_inc((int*) &allocator->current->number_of_pages);
+
+    return page;
+}
+
+void chunk_free_page(void *page) {
+    release_chunk(PAGE_CHUNK_OF(page));
+}
+
+#endif  /* SCM_PAGE_CHUNKS */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _CHUNK_H_
+#define	_CHUNK_H_
+
+#include "libscm.h"
+
+#if defined(SCM_DESCRIPTOR_PAGE_CHUNKS) || defined(SCM_REGION_PAGE_CHUNKS)
+#define SCM_PAGE_CHUNKS
+#endif
+
+#if defined(SCM_REGION_PAGE_CHUNKS) && defined(SCM_HEADERLESS_REGIONS)
+#error "SCM_REGION_PAGE_CHUNKS cannot be combined with SCM_HEADERLESS_REGIONS"
+#endif
+
+#ifdef SCM_PAGE_CHUNKS
+
+#include <stddef.h>
+
+/*
+ * Descriptor pages and region pages may be carved from chunks of
+ * SCM_PAGE_CHUNK_SIZE bytes that are mapped aligned to their size, which
+ * allows the kernel to back them with transparent huge pages.
+ *
+ * -------------------------  <- pointer to page_chunk_t (chunk-aligned)
+ * | number of pages       |
+ * -------------------------  <- PAGE_CHUNK_HEADER_SIZE
+ * | page 0                |
+ * ~ ...                   ~
+ * | page n - 1            |
+ * -------------------------
+ *
+ * Each thread carves pages from its current chunk by bumping an address.
+ * A chunk counts its pages that were not yet freed, plus one as long as it
+ * is the current chunk of a thread, and is unmapped as a whole once the
+ * count drops to zero. Pages may be freed by any thread.
+ */
+typedef struct page_chunk page_chunk_t;
+
+struct page_chunk {
+    volatile int number_of_pages;
+};
+
+// pages start behind the first 4K of a chunk and are cache-line-aligned
+#define PAGE_CHUNK_HEADER_SIZE 4096
+#define PAGE_CHUNK_ALIGNMENT 64
+
+#define PAGE_CHUNK_OF(_page) \
+    ((page_chunk_t*) ((unsigned long) (_page) \
+        & ~(unsigned long) (SCM_PAGE_CHUNK_SIZE - 1)))
+
+// the largest page that can be carved from a chunk
+#define PAGE_CHUNK_MAX_PAGE_SIZE (SCM_PAGE_CHUNK_SIZE - PAGE_CHUNK_HEADER_SIZE)
+
+/*
+ * The current chunk of a thread and the range of it that was not yet
+ * carved into pages.
+ */
+typedef struct page_chunk_allocator page_chunk_allocator_t;
+
+struct page_chunk_allocator {
+    page_chunk_t* current;
+
+    void* next_free_address;
+    void* last_address_in_chunk;
+};
+
+/*
+ * chunk_alloc_page() carves a page of size bytes from the current chunk of
+ * the allocator, mapping a new chunk if the page does not fit. Returns NULL
+ * if no chunk could be mapped. The memory of the page is zero.
+ */
+void* chunk_alloc_page(page_chunk_allocator_t *allocator, size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * chunk_free_page() releases a page of a chunk and unmaps the chunk if it
+ * was its last page.
+ */
+void chunk_free_page(void *page)
+    __attribute__((visibility("hidden")));
+
+#endif  /* SCM_PAGE_CHUNKS */
+
+#endif	/* _CHUNK_H_ */
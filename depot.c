@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#include "depot.h"
+
+#ifdef SCM_PAGE_DEPOT
+
+#include <stddef.h>
+
+#include "arch.h"
+
+int depot_push(depot_t *depot, void *magazine) {
+    int i;
+
+    for (i = 0; i < SCM_PAGE_DEPOT_SIZE; i++) {
+        //unsynchronized read, skips slots that are taken anyway
+        if (depot->magazines[i] == NULL
+                && atomic_pointer_compare_and_exchange(&depot->magazines[i],
+                                                       NULL, magazine) == NULL) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void* depot_pop(depot_t *depot) {
+    int i;
+
+    for (i = 0; i < SCM_PAGE_DEPOT_SIZE; i++) {
+        if (depot->magazines[i] != NULL) {
+            void *magazine = atomic_pointer_exchange(&depot->magazines[i], NULL);
+
+            if (magazine != NULL) {
+                return magazine;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+#endif  /* SCM_PAGE_DEPOT */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _DEPOT_H_
+#define	_DEPOT_H_
+
+#ifdef SCM_PAGE_DEPOT
+
+#include "libscm.h"
+
+/*
+ * A depot holds magazines of pages that are shared by all threads. A
+ * magazine is a full page pool of a thread, i.e. a list of pages linked
+ * through the pages themselves, which is handed off as a whole.
+ *
+ * The depot is an array of slots, each holding a magazine or NULL.
+ * Magazines are put into an empty slot with compare-and-exchange and taken
+ * out of a slot with exchange. Neither operation reads a magazine before it
+ * owns it, so the depot is lock-free and not prone to ABA.
+ */
+typedef struct depot depot_t;
+
+struct depot {
+    void* volatile magazines[SCM_PAGE_DEPOT_SIZE];
+};
+
+/*
+ * depot_push() puts a magazine into the depot. Returns 0 iff the depot
+ * is full.
+ */
+int depot_push(depot_t *depot, void *magazine)
+    __attribute__((visibility("hidden")));
+
+/*
+ * depot_pop() takes a magazine out of the depot, or returns NULL if the
+ * depot is empty.
+ */
+void* depot_pop(depot_t *depot)
+    __attribute__((visibility("hidden")));
+
+#endif  /* SCM_PAGE_DEPOT */
+
+#endif	/* _DEPOT_H_ */
@@ -7,11 +7,83 @@
 
 #include "descriptors.h"
 
-/**
- * Increments the current_index modulo the maximal expiration extension.
- */
-inline void increment_current_index(descriptor_buffer_t *buffer) {
-    buffer->current_index = (buffer->current_index + 1) % buffer->not_expired_length;
+#ifdef SCM_HEADERLESS_REGIONS
+#if (SCM_REGION_PAGE_SIZE & (SCM_REGION_PAGE_SIZE - 1)) != 0
+#error "SCM_HEADERLESS_REGIONS requires SCM_REGION_PAGE_SIZE to be a power of two"
+#endif
+
+arena_t region_page_arena = ARENA_INITIALIZER(SCM_REGION_ARENA_SIZE,
+                                              REGION_PAGE_UNIT_SIZE);
+#endif
+
+#if defined(SCM_REGION_PAGE_CHUNKS) \
+    && (SCM_REGION_PAGE_SIZE << SCM_REGION_PAGE_MAX_ORDER) > PAGE_CHUNK_MAX_PAGE_SIZE
+#error "SCM_PAGE_CHUNK_SIZE is too small for the largest region page"
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+// the descriptor roots by owner id - 1
+static descriptor_root_t* owners[SCM_MAX_BIASED_OWNERS];
+
+// the number of owner ids handed out so far
+static volatile int number_of_owners = 0;
+#endif
+
+#ifdef SCM_PAGE_DEPOT
+// full descriptor page pools of all threads
+static depot_t descriptor_page_depot;
+
+// full region page pools of all threads by page size
+static depot_t region_page_depots[REGION_PAGE_ORDERS];
+#endif
+
+void reserve_descriptor_buffer(descriptor_buffer_t *buffer,
+                               unsigned int max_expiration) {
+    unsigned int length = buffer->not_expired_length;
+
+    if (max_expiration < length) {
+        return;
+    }
+
+    unsigned int new_length = length > 0 ? length : 1;
+
+    while (new_length <= max_expiration) {
+        new_length <<= 1;
+    }
+
+    descriptor_page_list_t *lists =
+        __real_calloc(new_length, sizeof(descriptor_page_list_t));
+
+    if (lists == NULL) {
+#ifdef SCM_DEBUG
+        printf("Memory for descriptor buffer could not be allocated.\n");
+#endif
+        return;
+    }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_overhead(__real_malloc_usable_size(lists));
+    inc_allocated_mem(__real_malloc_usable_size(lists));
+#endif
+
+    if (length > 0) {
+        unsigned int i;
+
+        //the list at current_index becomes the first list of the new ring
+        for (i = 0; i < length; i++) {
+            lists[i] = buffer->not_expired[(buffer->current_index + i) & (length - 1)];
+        }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+        dec_overhead(__real_malloc_usable_size(buffer->not_expired));
+        inc_freed_mem(__real_malloc_usable_size(buffer->not_expired));
+#endif
+        __real_free(buffer->not_expired);
+    }
+
+    buffer->not_expired = lists;
+    buffer->not_expired_length = new_length;
+    buffer->current_index = 0;
 }
 
 /**
@@ -23,16 +95,39 @@ static descriptor_page_t *new_descriptor_page() {
 
     descriptor_page_t *new_page = NULL;
 
-    if (descriptor_root->number_of_pooled_descriptor_pages > 0) {
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+    descriptor_root->descriptor_page_pool_sizing.demand++;
+#endif
+
+#ifdef SCM_PAGE_DEPOT
+    if (descriptor_root->descriptor_page_pool == NULL) {
+        //refill the empty pool with a magazine of another thread
+        descriptor_page_t *magazine = depot_pop(&descriptor_page_depot);
+
+        descriptor_root->descriptor_page_pool = magazine;
+
+        while (magazine != NULL) {
+            descriptor_root->number_of_pooled_descriptor_pages++;
+            magazine = magazine->next;
+        }
+    }
+#endif
+
+    if (descriptor_root->descriptor_page_pool != NULL) {
+        new_page = descriptor_root->descriptor_page_pool;
+        descriptor_root->descriptor_page_pool = new_page->next;
         descriptor_root->number_of_pooled_descriptor_pages--;
-        new_page = descriptor_root->descriptor_page_pool
-                   [descriptor_root->number_of_pooled_descriptor_pages];
 
 #ifdef SCM_RECORD_MEMORY_USAGE
         dec_pooled_mem(sizeof(descriptor_page_t));
 #endif
     } else {
+#ifdef SCM_DESCRIPTOR_PAGE_CHUNKS
+        new_page = chunk_alloc_page(&descriptor_root->page_chunks,
+                                    SCM_DESCRIPTOR_PAGE_SIZE);
+#else
         new_page = __real_malloc(SCM_DESCRIPTOR_PAGE_SIZE);
+#endif
 
         if (!new_page) {
 #ifdef SCM_DEBUG
@@ -42,11 +137,11 @@ static descriptor_page_t *new_descriptor_page() {
         }
 
 #ifdef SCM_RECORD_MEMORY_USAGE
-        inc_overhead(__real_malloc_usable_size(new_page));
+        inc_overhead(DESCRIPTOR_PAGE_USABLE_SIZE(new_page));
 #endif
     }
 #ifdef SCM_RECORD_MEMORY_USAGE
-    inc_allocated_mem(__real_malloc_usable_size(new_page));
+    inc_allocated_mem(DESCRIPTOR_PAGE_USABLE_SIZE(new_page));
 #endif
 
     new_page->number_of_descriptors = 0;
@@ -55,33 +150,357 @@ static descriptor_page_t *new_descriptor_page() {
     return new_page;
 }
 
+/**
+ * Stores a descriptor in a descriptor page. Returns 0 iff the page is full.
+ */
+static inline int store_descriptor(descriptor_page_t *page, void *ptr) {
+    unsigned long index = page->number_of_descriptors;
+
+#ifdef SCM_COMPRESSED_DESCRIPTORS
+    if (index == 0) {
+        page->window = (void*) (uintptr_t) ((uint64_t) (uintptr_t) ptr
+            & ~(DESCRIPTOR_WINDOW_SIZE - 1));
+    }
+
+    uint64_t offset = (uint64_t) (uintptr_t) (ptr - page->window);
+
+    if (offset < DESCRIPTOR_WINDOW_SIZE && (offset & 3) == 0) {
+        if (index == DESCRIPTOR_SLOTS_PER_PAGE) {
+            return 0;
+        }
+
+        page->descriptors[index] = (unsigned int) (offset >> 1);
+        page->number_of_descriptors = index + 1;
+    } else {
+        //foreign descriptors fall back to full pointers
+        if (index + 2 > DESCRIPTOR_SLOTS_PER_PAGE) {
+            return 0;
+        }
+
+        page->descriptors[index] = (unsigned int) (uintptr_t) ptr | 1;
+        page->descriptors[index + 1] =
+            (unsigned int) ((uint64_t) (uintptr_t) ptr >> 32);
+        page->number_of_descriptors = index + 2;
+    }
+#else
+    if (index == DESCRIPTORS_PER_PAGE) {
+        return 0;
+    }
+
+    page->descriptors[index] = ptr;
+    page->number_of_descriptors = index + 1;
+#endif
+
+    return 1;
+}
+
+/**
+ * Loads the descriptor at index *index of a descriptor page and advances
+ * *index to the next descriptor.
+ */
+static inline void* load_descriptor(descriptor_page_t *page,
+                                    unsigned long *index) {
+#ifdef SCM_COMPRESSED_DESCRIPTORS
+    unsigned int slot = page->descriptors[*index];
+
+    if (slot & 1) {
+        uint64_t high = page->descriptors[*index + 1];
+
+        *index += 2;
+
+        return (void*) (uintptr_t) ((high << 32) | (slot & ~1U));
+    }
+
+    *index += 1;
+
+    return page->window + ((uint64_t) slot << 1);
+#else
+    return page->descriptors[(*index)++];
+#endif
+}
+
+#ifdef SCM_TIMING_WHEEL
+/**
+ * Appends the pages of list src to list dst and empties src. An empty page
+ * that was left at the beginning of dst by expire_buffer is moved to the
+ * end of dst.
+ */
+static inline void splice_descriptor_page_list(descriptor_page_list_t *dst,
+                                               descriptor_page_list_t *src) {
+    if (dst->first == NULL) {
+        *dst = *src;
+    } else if (dst->first->number_of_descriptors == 0) {
+        src->last->next = dst->first;
+        dst->first = src->first;
+    } else {
+        dst->last->next = src->first;
+        dst->last = src->last;
+    }
+
+    src->first = NULL;
+    src->last = NULL;
+}
+
+/**
+ * Appends a single page to the end of a list.
+ */
+static inline void append_to_descriptor_page_list(descriptor_page_list_t *list,
+                                                  descriptor_page_t *page) {
+    page->next = NULL;
+
+    if (list->first == NULL) {
+        list->first = page;
+    } else {
+        list->last->next = page;
+    }
+
+    list->last = page;
+}
+
+/**
+ * Returns the list of the timing wheel for descriptors that expire at
+ * expiration_tick, or NULL if they are kept in the ring.
+ */
+static descriptor_page_list_t* get_timing_wheel_list(
+        descriptor_buffer_t *buffer, unsigned long expiration_tick) {
+
+    if (buffer->wheel == NULL) {
+        buffer->wheel = __real_calloc(
+            SCM_TIMING_WHEEL_LEVELS * TIMING_WHEEL_LISTS,
+            sizeof(descriptor_page_list_t));
+
+        if (buffer->wheel == NULL) {
+#ifdef SCM_DEBUG
+            printf("Memory for timing wheel could not be allocated.\n");
+#endif
+            return NULL;
+        }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+        inc_overhead(__real_malloc_usable_size(buffer->wheel));
+        inc_allocated_mem(__real_malloc_usable_size(buffer->wheel));
+#endif
+    }
+
+    unsigned long now = buffer->ticks;
+
+    //level 0 is drained tick by tick, its slot of the current tick is open
+    if ((expiration_tick >> TIMING_WHEEL_SLOT_BITS)
+            - (now >> TIMING_WHEEL_SLOT_BITS) < SCM_TIMING_WHEEL_SLOTS) {
+        return TIMING_WHEEL_LIST(buffer, 0, expiration_tick);
+    }
+
+    unsigned int level;
+
+    for (level = 1; level < SCM_TIMING_WHEEL_LEVELS; level++) {
+        unsigned int shift = (level + 1) * TIMING_WHEEL_SLOT_BITS;
+
+        //higher levels cascade a slot at its first tick, so the slot of
+        //the current tick is closed already
+        if ((expiration_tick >> shift) - (now >> shift) <= SCM_TIMING_WHEEL_SLOTS) {
+            return TIMING_WHEEL_LIST(buffer, level, expiration_tick);
+        }
+    }
+
+    //too far ahead for the wheel
+    return NULL;
+}
+
+/**
+ * Returns the last page of a sub-slot list of the timing wheel if it holds
+ * descriptors expiring at expiration_tick, or a new page for them, which
+ * is appended to the list. Sub-slots of level 0 hold a single tick.
+ */
+static descriptor_page_t* get_timing_wheel_page(descriptor_page_list_t *list,
+                                                unsigned long expiration_tick) {
+    descriptor_page_t *page = list->last;
+
+    if (page != NULL && page->expiration_tick == expiration_tick) {
+        return page;
+    }
+
+    page = new_descriptor_page();
+    page->expiration_tick = expiration_tick;
+
+    append_to_descriptor_page_list(list, page);
+
+    return page;
+}
+
+void cascade_timing_wheel(descriptor_buffer_t *buffer) {
+    unsigned long now = buffer->ticks;
+    int level;
+
+    //higher levels first, their pages may expire in the slots of the
+    //levels below that start at the current tick
+    for (level = SCM_TIMING_WHEEL_LEVELS - 1; level > 0; level--) {
+        unsigned int shift = (level + 1) * TIMING_WHEEL_SLOT_BITS;
+        unsigned int sub_slot;
+
+        //slots of higher levels start at multiples of the lower slots
+        if (now & ((1UL << shift) - 1)) {
+            continue;
+        }
+
+        //move each page into the sub-slot of the level below that holds
+        //its expiration tick
+        for (sub_slot = 0; sub_slot < SCM_TIMING_WHEEL_SLOTS; sub_slot++) {
+            descriptor_page_list_t *list = TIMING_WHEEL_LIST(buffer, level,
+                now + ((unsigned long) sub_slot << (shift - TIMING_WHEEL_SLOT_BITS)));
+            descriptor_page_t *page = list->first;
+
+            while (page != NULL) {
+                descriptor_page_t *next = page->next;
+
+                append_to_descriptor_page_list(
+                    TIMING_WHEEL_LIST(buffer, level - 1, page->expiration_tick), page);
+
+                page = next;
+            }
+
+            list->first = NULL;
+            list->last = NULL;
+        }
+    }
+
+    //the sub-slot of level 0 of the current tick joins the list of the
+    //ring that is expired right after this tick
+    descriptor_page_list_t *list = TIMING_WHEEL_LIST(buffer, 0, now);
+
+    if (list->first == NULL) {
+        return;
+    }
+
+    splice_descriptor_page_list(&buffer->not_expired[
+        (buffer->current_index - 1) & (buffer->not_expired_length - 1)], list);
+}
+#endif
+
+/**
+ * Returns the page of the descriptor buffer for descriptors that expire
+ * after expiration ticks and stores its list in *list. Descriptors are
+ * stored in the returned page, or in new pages that are inserted after it.
+ */
+static inline descriptor_page_t* get_descriptor_page(
+        descriptor_buffer_t *buffer, unsigned int expiration,
+        descriptor_page_list_t **list) {
+
+    if (expiration >= buffer->not_expired_length) {
+#ifdef SCM_TIMING_WHEEL
+        //descriptors in the list at expiration ticks ahead of current_index
+        //are expired by the tick that sets ticks to that tick + 1
+        unsigned long expiration_tick = buffer->ticks + expiration + 1;
+
+        *list = get_timing_wheel_list(buffer, expiration_tick);
+
+        if (*list != NULL) {
+            return get_timing_wheel_page(*list, expiration_tick);
+        }
+#endif
+        reserve_descriptor_buffer(buffer, expiration);
+
+        if (expiration >= buffer->not_expired_length) {
+            //the ring could not grow
+            expiration = buffer->not_expired_length - 1;
+        }
+    }
+
+    unsigned int insert_index =
+        (buffer->current_index + expiration) & (buffer->not_expired_length - 1);
+
+    *list = &buffer->not_expired[insert_index];
+
+    if ((*list)->first == NULL) {
+        (*list)->first = new_descriptor_page();
+        (*list)->last = (*list)->first;
+    }
+
+    //insert in the last page
+    return (*list)->last;
+}
+
+/**
+ * Inserts a new descriptor page after page into the list.
+ */
+static inline descriptor_page_t* append_descriptor_page(
+        descriptor_page_list_t *list, descriptor_page_t *page) {
+    descriptor_page_t *new_page = new_descriptor_page();
+
+#ifdef SCM_TIMING_WHEEL
+    new_page->expiration_tick = page->expiration_tick;
+#endif
+
+    new_page->next = page->next;
+    page->next = new_page;
+
+    if (list->last == page) {
+        list->last = new_page;
+    }
+
+    return new_page;
+}
+
 /*
  * Inserts a descriptor for the object or region
  * provided as parameter 'ptr' */
 void insert_descriptor(void* ptr, descriptor_buffer_t *buffer,
                        unsigned int expiration) {
 
-    unsigned int insert_index = (buffer->current_index + expiration) % buffer->not_expired_length;
+    descriptor_page_list_t *list;
+    descriptor_page_t *page = get_descriptor_page(buffer, expiration, &list);
 
-    descriptor_page_list_t *list = &buffer->not_expired[insert_index];
+    if (!store_descriptor(page, ptr)) {
+        //page is full. create new page and insert it after the page
+        page = append_descriptor_page(list, page);
 
-    if (list->first == NULL) {
-        list->first = new_descriptor_page();
-        list->last = list->first;
+        store_descriptor(page, ptr);
     }
+}
 
-    //insert in the last page
-    descriptor_page_t *page = list->last;
-
-    if (page->number_of_descriptors == DESCRIPTORS_PER_PAGE) {
-        //page is full. create new page and append to end of list
-        page = new_descriptor_page();
-        list->last->next = page;
-        list->last = page;
+/*
+ * Inserts descriptors for the n objects or regions
+ * provided in 'ptrs'. Runs of descriptors are copied
+ * into the pages as a whole. */
+void insert_descriptors(void** ptrs, unsigned long n,
+                        descriptor_buffer_t *buffer, unsigned int expiration) {
+
+    if (n == 0) {
+        return;
     }
 
-    page->descriptors[page->number_of_descriptors] = ptr;
-    page->number_of_descriptors++;
+    descriptor_page_list_t *list;
+    descriptor_page_t *page = get_descriptor_page(buffer, expiration, &list);
+
+    while (n > 0) {
+#ifdef SCM_COMPRESSED_DESCRIPTORS
+        //compressed descriptors are encoded one by one
+        if (!store_descriptor(page, *ptrs)) {
+            page = append_descriptor_page(list, page);
+            continue;
+        }
+
+        ptrs++;
+        n--;
+#else
+        unsigned long run = DESCRIPTORS_PER_PAGE - page->number_of_descriptors;
+
+        if (run == 0) {
+            page = append_descriptor_page(list, page);
+            continue;
+        }
+
+        if (run > n) {
+            run = n;
+        }
+
+        memcpy(&page->descriptors[page->number_of_descriptors], ptrs,
+               run * sizeof(void*));
+        page->number_of_descriptors += run;
+
+        ptrs += run;
+        n -= run;
+#endif
+    }
 }
 
 /*
@@ -91,10 +510,8 @@ void insert_descriptor(void* ptr, descriptor_buffer_t *buffer,
 void expire_buffer(descriptor_buffer_t *buffer,
                    expired_descriptor_page_list_t *exp_list) {
 
-    int to_be_expired_index = buffer->current_index - 1;
-
-    if (to_be_expired_index < 0)
-        to_be_expired_index += buffer->not_expired_length;
+    unsigned int to_be_expired_index =
+        (buffer->current_index - 1) & (buffer->not_expired_length - 1);
 
     descriptor_page_list_t *just_expired_page_list = &buffer->not_expired[to_be_expired_index];
 
@@ -102,6 +519,14 @@ void expire_buffer(descriptor_buffer_t *buffer,
 
         if (just_expired_page_list->first->number_of_descriptors != 0) {
 
+            descriptor_page_t *page = just_expired_page_list->first;
+
+            //count the descriptors per page, not per descriptor
+            while (page != NULL) {
+                exp_list->pending += page->number_of_descriptors;
+                page = page->next;
+            }
+
             //append page_list to expired_page_list
             if (exp_list->first == NULL) {
                 exp_list->first = just_expired_page_list->first;
@@ -123,25 +548,48 @@ void expire_buffer(descriptor_buffer_t *buffer,
     }
 }
 
+/**
+ * Hands a descriptor page back to its chunk or the OS.
+ */
+static void free_descriptor_page(descriptor_page_t *page) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_overhead(DESCRIPTOR_PAGE_USABLE_SIZE(page));
+    inc_freed_mem(DESCRIPTOR_PAGE_USABLE_SIZE(page));
+#endif
+
+#ifdef SCM_DESCRIPTOR_PAGE_CHUNKS
+    chunk_free_page(page);
+#else
+    __real_free(page);
+#endif
+}
+
 static inline void recycle_descriptor_page(descriptor_page_t *page) {
 
+#ifdef SCM_PAGE_DEPOT
+    //hand off the full pool to the depot
+    if (descriptor_root->descriptor_page_pool != NULL
+            && descriptor_root->number_of_pooled_descriptor_pages
+            >= DESCRIPTOR_PAGE_POOL_LIMIT
+            && depot_push(&descriptor_page_depot,
+                          descriptor_root->descriptor_page_pool)) {
+        descriptor_root->descriptor_page_pool = NULL;
+        descriptor_root->number_of_pooled_descriptor_pages = 0;
+    }
+#endif
+
     if (descriptor_root->number_of_pooled_descriptor_pages <
-            SCM_DESCRIPTOR_PAGE_FREELIST_SIZE) {
+            DESCRIPTOR_PAGE_POOL_LIMIT) {
 
-        descriptor_root->descriptor_page_pool[descriptor_root->number_of_pooled_descriptor_pages] = page;
-    
+        page->next = descriptor_root->descriptor_page_pool;
+        descriptor_root->descriptor_page_pool = page;
         descriptor_root->number_of_pooled_descriptor_pages++;
 
 #ifdef SCM_RECORD_MEMORY_USAGE
         inc_pooled_mem(sizeof(descriptor_page_t));
 #endif
     } else {
-#ifdef SCM_RECORD_MEMORY_USAGE
-        dec_overhead(__real_malloc_usable_size(page));
-        inc_freed_mem(__real_malloc_usable_size(page));
-#endif
-
-        __real_free(page);
+        free_descriptor_page(page);
     }
 }
 
@@ -193,11 +641,38 @@ static void* get_expired_memory(expired_descriptor_page_list_t *list) {
     }
 #endif
 
-    void* expired_memory = page->descriptors[list->collected];
+    unsigned long slot = list->collected;
 
-    list->collected++;
+    void *ptr = load_descriptor(page, &list->collected);
 
-    return expired_memory;
+    //compressed descriptors may take more than one slot
+    list->pending -= list->collected - slot;
+
+    return ptr;
+}
+
+/*
+ * Runs the finalizer of an object without descriptors and frees it,
+ * unless the finalizer fails.
+ */
+static void reclaim_object(object_header_t *object) {
+    int finalizer_result = run_finalizer(object);
+
+    if (finalizer_result != 0) {
+#ifdef SCM_DEBUG
+        printf("WARNING: finalizer returned %d.\n", finalizer_result);
+        printf("WARNING: %lx is a leak.\n",
+               (unsigned long) PAYLOAD_OFFSET(object));
+#endif
+
+        return; //do not free the object
+    }
+
+#ifdef SCM_DEBUG
+    printf("Object FREE(%lx).\n", (unsigned long) PAYLOAD_OFFSET(object));
+#endif
+
+    free_object(object);
 }
 
 /*
@@ -219,30 +694,9 @@ int expire_object_descriptor_if_exists(expired_descriptor_page_list_t *list) {
 
     if (expired_object != NULL) {
         //decrement the descriptor counter of the expired object
-        if (atomic_int_dec_and_test((int*) &expired_object->dc_or_region_id)) {
+        if (decrement_descriptor_counter_and_test(expired_object)) {
             //with the descriptor counter now zero run finalizer and free it
-            int finalizer_result = run_finalizer(expired_object);
-
-            if (finalizer_result != 0) {
-#ifdef SCM_DEBUG
-                printf("WARNING: finalizer returned %d.\n", finalizer_result);
-                printf("WARNING: %lx is a leak.\n",
-                       (unsigned long) PAYLOAD_OFFSET(expired_object));
-#endif
-
-                return 1; //do not free the object
-            }
-
-#ifdef SCM_DEBUG
-            printf("Object FREE(%lx).\n",
-                   (unsigned long) PAYLOAD_OFFSET(expired_object));
-#endif
-
-#ifdef SCM_RECORD_MEMORY_USAGE
-            dec_overhead(sizeof(object_header_t));
-            inc_freed_mem(__real_malloc_usable_size(expired_object));
-#endif
-            __real_free(expired_object);
+            reclaim_object(expired_object);
 
             return 1;
         } else {
@@ -260,13 +714,115 @@ int expire_object_descriptor_if_exists(expired_descriptor_page_list_t *list) {
 }
 
 /**
- * Recycles a region in O(1) by pooling
- * the list of free region_pages except the
- * first region page iff the region_page_pool
- * limit is not exceeded, otherwise the region_pages
- * except the first one are deallocated and
- * the memory is handed back to the OS in O(n),
- * n = amount of region pages - 1.
+ * Pools the oversized pages of a region for re-use or hands them back to
+ * malloc if the pool is full or the page is too large to be kept.
+ */
+static void recycle_oversized_pages(region_t* region) {
+    oversized_page_t* page = region->oversized_pages;
+
+    while (page != NULL) {
+        oversized_page_t* next = page->next;
+
+        if (descriptor_root->number_of_pooled_oversized_pages
+                < SCM_OVERSIZED_PAGE_FREELIST_SIZE
+                && page->size <= SCM_MAX_POOLED_OVERSIZED_PAGE_SIZE) {
+            page->next = descriptor_root->oversized_page_pool;
+            descriptor_root->oversized_page_pool = page;
+            descriptor_root->number_of_pooled_oversized_pages++;
+#ifdef SCM_RECORD_MEMORY_USAGE
+            inc_pooled_mem(page->size);
+#endif
+        } else {
+#ifdef SCM_RECORD_MEMORY_USAGE
+            inc_freed_mem(page->size);
+#endif
+            __real_free(page);
+        }
+
+        page = next;
+    }
+
+    region->oversized_pages = NULL;
+}
+
+/**
+ * Returns the order of the region page that follows a page of the given
+ * order in a region.
+ */
+static inline unsigned int next_page_order(region_t* region, unsigned long order) {
+    return order < region->max_page_order ? order + 1 : region->max_page_order;
+}
+
+#ifdef SCM_PAGE_DEPOT
+void refill_region_page_pool(unsigned int order) {
+    region_page_t* magazine = depot_pop(&region_page_depots[order]);
+
+    descriptor_root->region_page_pool[order] = magazine;
+
+    while (magazine != NULL) {
+        descriptor_root->number_of_pooled_region_pages[order]++;
+        magazine = magazine->nextPage;
+    }
+}
+#endif
+
+/**
+ * Hands a region page back to the arena, its chunk, or the OS.
+ */
+static void free_region_page(region_page_t* page) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_freed_mem(REGION_PAGE_SIZE(page->order));
+#endif
+
+#ifdef SCM_HEADERLESS_REGIONS
+    arena_free(&region_page_arena, page);
+#elif defined(SCM_REGION_PAGE_CHUNKS)
+    chunk_free_page(page);
+#else
+    __real_free(page);
+#endif
+}
+
+/**
+ * Pools a region page in the pool of its size or hands it back if
+ * that pool is full. With SCM_PAGE_DEPOT a full pool is handed off to the
+ * depot first.
+ */
+static void recycle_region_page(region_page_t* page) {
+    unsigned long order = page->order;
+
+#ifdef SCM_PAGE_DEPOT
+    if (descriptor_root->region_page_pool[order] != NULL
+            && descriptor_root->number_of_pooled_region_pages[order]
+            >= REGION_PAGE_POOL_LIMIT(order)
+            && depot_push(&region_page_depots[order],
+                          descriptor_root->region_page_pool[order])) {
+        descriptor_root->region_page_pool[order] = NULL;
+        descriptor_root->number_of_pooled_region_pages[order] = 0;
+    }
+#endif
+
+    if (descriptor_root->number_of_pooled_region_pages[order]
+            < REGION_PAGE_POOL_LIMIT(order)) {
+        page->nextPage = descriptor_root->region_page_pool[order];
+        descriptor_root->region_page_pool[order] = page;
+        descriptor_root->number_of_pooled_region_pages[order]++;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+        inc_pooled_mem(REGION_PAGE_SIZE(order));
+#endif
+    } else {
+        free_region_page(page);
+    }
+}
+
+/**
+ * Recycles a region by pooling the region_pages
+ * except the first region page in the pools of their
+ * size. Pages whose pool is full are deallocated and
+ * the memory is handed back to the OS. Recycling takes
+ * O(n), n = amount of region pages - 1, which stays
+ * small for regions whose pages grow geometrically.
  *
  * The remaining first region page indicates that the region
  * once existed, which is necessary to differentiate
@@ -302,6 +858,11 @@ static void recycle_region(region_t* region) {
     region_t* invar_region = region;
 #endif
 
+    recycle_oversized_pages(region);
+
+    // the pages keep track of their dirty memory while they are pooled
+    mark_region_page_dirty(region);
+
     region_page_t* legacy_pages;
     unsigned long number_of_recycle_region_pages;
 
@@ -309,11 +870,17 @@ static void recycle_region(region_t* region) {
     if (region->age == descriptor_root->current_time) {
         //.. recycle everything except the first page
         region_page_t* firstPage = region->firstPage;
+        unsigned long order = firstPage->order;
         legacy_pages = firstPage->nextPage;
 
-        memset(firstPage, '\0', SCM_REGION_PAGE_SIZE);
+        // the memory of the first page is zeroed lazily when it is
+        // allocated again
+        firstPage->nextPage = NULL;
+        region->next_free_address = firstPage->memory;
+        region->last_object = NULL;
         region->last_address_in_last_page =
-                firstPage->memory + SCM_REGION_PAGE_PAYLOAD_SIZE;
+                firstPage->memory + REGION_PAGE_PAYLOAD_SIZE(order);
+        region->page_order = next_page_order(region, order);
 
         // nothing to put into the pool
         if (legacy_pages == NULL) {
@@ -400,85 +967,27 @@ static void recycle_region(region_t* region) {
             region->number_of_region_pages;
     }
 
-    unsigned long number_of_pooled_region_pages =
-        descriptor_root->number_of_pooled_region_pages;
-
-    // is there space in the region page pool?
-    if ((number_of_pooled_region_pages
-            + number_of_recycle_region_pages) <=
-            SCM_REGION_PAGE_FREELIST_SIZE) {
-        //..yes, there is space in the region page pool
-
-#ifdef SCM_RECORD_MEMORY_USAGE
-        region_page_t* p = legacy_pages;
-
-        while(p != NULL) {
-            inc_pooled_mem(SCM_REGION_PAGE_SIZE);
-            inc_overhead(__real_malloc_usable_size(p));
-
-            p = p->nextPage;
-        }
-#endif
-
-        region_page_t* first_in_pool = descriptor_root->region_page_pool;
-        region_page_t* last_page = region->lastPage;
-
-        last_page->nextPage = first_in_pool;
-        descriptor_root->region_page_pool = legacy_pages;
-        descriptor_root->number_of_pooled_region_pages =
-            number_of_pooled_region_pages + number_of_recycle_region_pages;
-
-    } else {
-
-        //..no, there is no space in the region page pool
-        // If the first region page is not NULL,
-        // deallocate all region pages
-        region_page_t* page2free = legacy_pages;
-
-        while (page2free != NULL && (number_of_pooled_region_pages
-                + number_of_recycle_region_pages) >
-                SCM_REGION_PAGE_FREELIST_SIZE) {
-            region_page_t* next = page2free->nextPage;
-            __real_free(page2free);
-
-#ifdef SCM_RECORD_MEMORY_USAGE
-            inc_freed_mem(SCM_REGION_PAGE_SIZE);
-#endif
-
-            page2free = next;
-
-            number_of_recycle_region_pages--;
-        }
+    //the first page may be recycled as well if the region is a zombie
+    unsigned long first_order = region->firstPage->order;
 
+    // pool the pages by size or hand them back if their pool is full
+    region_page_t* page = legacy_pages;
 
-        // check again if we can recycle now
-        if (page2free != NULL && (number_of_pooled_region_pages
-                + number_of_recycle_region_pages) <=
-                SCM_REGION_PAGE_FREELIST_SIZE) {
-            
-            region_page_t* first_in_pool = descriptor_root->region_page_pool;
-            region_page_t* last_page = region->lastPage;
-            if(last_page != NULL) {
-                last_page->nextPage = first_in_pool;
-                descriptor_root->region_page_pool = page2free;
-                descriptor_root->number_of_pooled_region_pages =
-                        number_of_recycle_region_pages - 1;
+    while (page != NULL && number_of_recycle_region_pages > 0) {
+        region_page_t* next = page->nextPage;
 
-#ifdef SCM_RECORD_MEMORY_USAGE
-                inc_pooled_mem(number_of_recycle_region_pages * SCM_REGION_PAGE_SIZE);
-#endif
-            }
-        }
+        recycle_region_page(page);
 
-        descriptor_root->number_of_pooled_region_pages =
-                number_of_pooled_region_pages + number_of_recycle_region_pages;
+        page = next;
+        number_of_recycle_region_pages--;
     }
 
     region->number_of_region_pages = 1;
     region->lastPage = region->firstPage;
-    region->last_address_in_last_page =
-            region->lastPage->memory + SCM_REGION_PAGE_PAYLOAD_SIZE;
+    region->last_address_in_last_page = region->lastPage->memory
+            + REGION_PAGE_PAYLOAD_SIZE(first_order);
     region->next_free_address = region->lastPage->memory;
+    region->last_object = NULL;
 
 // check post-conditions
 #ifdef SCM_CHECK_CONDITIONS
@@ -559,4 +1068,190 @@ int expire_region_descriptor_if_exists(expired_descriptor_page_list_t *list) {
 #endif
         return 0;
     }
-}
\ No newline at end of file
+}
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+/*
+ * Runs on the reclaimer thread, which has no descriptor root. Sharded
+ * objects are uncounted in the shard of the thread that expired them.
+ */
+void reclaim_expired_objects(descriptor_root_t *root, descriptor_page_t *first) {
+    descriptor_page_t *page = first;
+    descriptor_page_t *last = NULL;
+
+    while (page != NULL) {
+        unsigned long index = 0;
+
+        while (index < page->number_of_descriptors) {
+            object_header_t *object = load_descriptor(page, &index);
+            bool expired;
+
+#ifdef SCM_SHARDED_COUNTERS
+            if (get_object_allocator(object) == OBJECT_ALLOCATOR_SHARDED) {
+                expired = decrement_sharded_counter_and_test(object,
+                                                             root->counter_shard);
+            } else
+#endif
+            expired = atomic_int_dec_and_test((int*) &object->dc_or_region_id);
+
+            if (expired) {
+                reclaim_object(object);
+            }
+        }
+
+        last = page;
+        page = page->next;
+    }
+
+    //descriptor pages are pooled per thread, give them back
+    descriptor_page_t *head;
+
+    do {
+        head = root->reclaimed_pages;
+        last->next = head;
+    } while (atomic_pointer_compare_and_exchange(
+                (void* volatile*) &root->reclaimed_pages, head, first) != head);
+}
+
+void recycle_reclaimed_descriptor_pages() {
+    descriptor_page_t *page = atomic_pointer_exchange(
+        (void* volatile*) &descriptor_root->reclaimed_pages, NULL);
+
+    while (page != NULL) {
+        descriptor_page_t *next = page->next;
+
+        recycle_descriptor_page(page);
+
+        page = next;
+    }
+}
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+void register_owner(descriptor_root_t *root) {
+    int id = atomic_int_exchange_and_add(&number_of_owners, 1) + 1;
+
+    if (id > SCM_MAX_BIASED_OWNERS) {
+#ifdef SCM_DEBUG
+        printf("No owner id left, objects are counted atomically.\n");
+#endif
+        return;
+    }
+
+    owners[id - 1] = root;
+    root->owner_id = id;
+}
+
+void queue_for_merge(object_header_t *object) {
+    descriptor_root_t *owner = owners[object->owner - 1];
+    object_header_t *head;
+
+    //only the thread that set DC_QUEUED links the object
+    do {
+        head = owner->merge_queue;
+        object->merge_next = head;
+    } while (atomic_pointer_compare_and_exchange(
+                (void* volatile*) &owner->merge_queue, head, object) != head);
+}
+
+void merge_queued_objects() {
+    object_header_t *object = atomic_pointer_exchange(
+        (void* volatile*) &descriptor_root->merge_queue, NULL);
+
+    while (object != NULL) {
+        //the link is read before the object leaves the queue
+        object_header_t *next = object->merge_next;
+
+        //leave the queue and merge unless we still count descriptors
+        int delta = -DC_QUEUED;
+
+        if (object->biased_dc == 0 && !(object->dc_or_region_id & DC_MERGED)) {
+            delta += DC_MERGED;
+        }
+
+        if (atomic_int_exchange_and_add(&object->dc_or_region_id, delta)
+                + delta == DC_MERGED) {
+            reclaim_object(object);
+        }
+
+        object = next;
+    }
+}
+#endif
+
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+void init_page_pools(descriptor_root_t *root) {
+    unsigned int order;
+
+    root->descriptor_page_pool_sizing.limit =
+        SCM_DESCRIPTOR_PAGE_FREELIST_SIZE;
+
+    for (order = 0; order < REGION_PAGE_ORDERS; order++) {
+        root->region_page_pool_sizing[order].limit =
+            SCM_REGION_PAGE_FREELIST_SIZE;
+    }
+}
+
+/**
+ * Adapts the limit of a page pool to the demand since the last tick.
+ * The high watermark peak_demand rises with the demand immediately and
+ * decays by 1/2^SCM_PAGE_POOL_DECAY per tick otherwise. The limit follows
+ * the high watermark but stays between the low watermark min_limit and
+ * SCM_MAX_POOLED_PAGES.
+ */
+static void resize_page_pool(page_pool_sizing_t *sizing, unsigned long min_limit) {
+    unsigned long decay = (sizing->peak_demand
+        + (1UL << SCM_PAGE_POOL_DECAY) - 1) >> SCM_PAGE_POOL_DECAY;
+
+    if (sizing->demand > sizing->peak_demand - decay) {
+        sizing->peak_demand = sizing->demand;
+    } else {
+        sizing->peak_demand -= decay;
+    }
+    sizing->demand = 0;
+
+    sizing->limit = sizing->peak_demand;
+
+    if (sizing->limit < min_limit) {
+        sizing->limit = min_limit;
+    } else if (sizing->limit > SCM_MAX_POOLED_PAGES) {
+        sizing->limit = SCM_MAX_POOLED_PAGES;
+    }
+}
+
+void resize_page_pools() {
+    unsigned int order;
+
+    resize_page_pool(&descriptor_root->descriptor_page_pool_sizing,
+                     SCM_DESCRIPTOR_PAGE_FREELIST_SIZE);
+
+    while (descriptor_root->number_of_pooled_descriptor_pages
+            > DESCRIPTOR_PAGE_POOL_LIMIT) {
+        descriptor_page_t *page = descriptor_root->descriptor_page_pool;
+
+        descriptor_root->descriptor_page_pool = page->next;
+        descriptor_root->number_of_pooled_descriptor_pages--;
+#ifdef SCM_RECORD_MEMORY_USAGE
+        dec_pooled_mem(sizeof(descriptor_page_t));
+#endif
+        free_descriptor_page(page);
+    }
+
+    for (order = 0; order < REGION_PAGE_ORDERS; order++) {
+        resize_page_pool(&descriptor_root->region_page_pool_sizing[order],
+                         SCM_REGION_PAGE_FREELIST_SIZE);
+
+        while (descriptor_root->number_of_pooled_region_pages[order]
+                > REGION_PAGE_POOL_LIMIT(order)) {
+            region_page_t *page = descriptor_root->region_page_pool[order];
+
+            descriptor_root->region_page_pool[order] = page->nextPage;
+            descriptor_root->number_of_pooled_region_pages[order]--;
+#ifdef SCM_RECORD_MEMORY_USAGE
+            dec_pooled_mem(REGION_PAGE_SIZE(order));
+#endif
+            free_region_page(page);
+        }
+    }
+}
+#endif
@@ -11,29 +11,74 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include "debug.h"
 #include "arch.h"
 #include "meter.h"
 #include "finalizer.h"
 #include "object.h"
+#include "slab.h"
+#include "depot.h"
+#include "chunk.h"
+#include "span.h"
+#include "large_object.h"
+#include "shard.h"
 #include "libscm.h"
 
+#ifdef SCM_TIMING_WHEEL
+// descriptor pages remember their expiration tick (see descriptor_buffer)
+#define DESCRIPTOR_PAGE_HEADER_WORDS 3
+#else
+#define DESCRIPTOR_PAGE_HEADER_WORDS 2
+#endif
+
+#ifdef SCM_COMPRESSED_DESCRIPTORS
+/*
+ * Compressed descriptors are 32-bit slots. A descriptor that points into the
+ * DESCRIPTOR_WINDOW_SIZE-aligned window of its page, which is the window of
+ * the first descriptor of the page, e.g. an arena, is stored in one slot as
+ * its offset to the window divided by 2, which is even for the 4-byte
+ * aligned side headers of headerless objects, too. Other descriptors
+ * are stored as full pointers in two slots: the low word with the lowest
+ * bit set, followed by the high word.
+ */
+#define DESCRIPTOR_SLOTS_PER_PAGE \
+    ((SCM_DESCRIPTOR_PAGE_SIZE - (DESCRIPTOR_PAGE_HEADER_WORDS + 1) \
+        * sizeof(void*))/sizeof(unsigned int))
+
+#define DESCRIPTOR_WINDOW_SIZE (1ULL << 33)
+#else
 #ifndef DESCRIPTORS_PER_PAGE
 #define DESCRIPTORS_PER_PAGE \
-    ((SCM_DESCRIPTOR_PAGE_SIZE - 2 * sizeof(void*))/sizeof(void*))
+    ((SCM_DESCRIPTOR_PAGE_SIZE - DESCRIPTOR_PAGE_HEADER_WORDS \
+        * sizeof(void*))/sizeof(void*))
+#endif
 #endif
 
 /*
  * A chunk of contiguous memory that holds descriptors with the same
- * expiration date.
+ * expiration date. With SCM_COMPRESSED_DESCRIPTORS, number_of_descriptors
+ * counts the used slots.
  */
 typedef struct descriptor_page descriptor_page_t;
 
 struct descriptor_page {
     descriptor_page_t *next;
     unsigned long number_of_descriptors;
+#ifdef SCM_TIMING_WHEEL
+    // the tick of the descriptor buffer at which the descriptors of a
+    // page in the timing wheel expire
+    unsigned long expiration_tick;
+#endif
+#ifdef SCM_COMPRESSED_DESCRIPTORS
+    void* window;
+    unsigned int descriptors[DESCRIPTOR_SLOTS_PER_PAGE];
+#else
     object_header_t* descriptors[DESCRIPTORS_PER_PAGE];
+#endif
 };
 
 /* 
@@ -55,35 +100,47 @@ struct expired_descriptor_page_list {
     descriptor_page_t* first;
     descriptor_page_t* last;
     unsigned long collected;
+    // the number of descriptor slots in the list that are not collected yet
+    unsigned long pending;
 };
 
 /*
- * Statically allocate memory for the locally clocked descriptor buffers.
- * Size of the locally clocked buffer is SCM_MAX_EXPIRATION_EXTENSION + 1
+ * A descriptor buffer is a ring of descriptor page lists, one per tick.
+ * The ring of a locally clocked buffer has more than max. extension slots
  * because of the additional slot for:
- * 1. slot for the current time
+ *  1. slot for the current time
  *
- * Statically allocate memory for the globally clocked descriptor buffers.
- * Size of the globally clocked buffer is SCM_MAX_EXPIRATION_EXTENSION + 2
- * because of the additional slots for:
+ * The ring of the globally clocked buffer has more than
+ * max. extension + 2 slots because of the additional slots for:
  *  1. slot for the current time
- *  2. adding descriptors at current + increment + 1
+ *  2. adding descriptors at current + increment + 2
  *
- * Note: both buffers allocate SCM_MAX_EXPIRATION_EXTENSION + 2 slots for
- * page_lists but the locally clocked buffer uses only
- * SCM_MAX_EXPIRATION_EXTENSION + 1 slots
+ * The length of a ring is a power of two. Rings are allocated when
+ * a buffer is first used, sized for the expiration extension expected
+ * for its clock, and grow when longer extensions are used.
+ *
+ * With SCM_TIMING_WHEEL, descriptors that expire beyond the ring are kept
+ * in a timing wheel of SCM_TIMING_WHEEL_LEVELS levels instead. A slot of
+ * level k collects the descriptors that expire within the same
+ * SCM_TIMING_WHEEL_SLOTS^(k+1) ticks in SCM_TIMING_WHEEL_SLOTS sub-slots,
+ * one per SCM_TIMING_WHEEL_SLOTS^k ticks, which are page lists indexed
+ * by the expiration tick. The sub-slots of level 0 hold a single tick, so
+ * descriptors are always appended to the last page of their sub-slot. The
+ * pages of a sub-slot hold the descriptors of a single expiration tick
+ * each. When time reaches the first tick of a slot of level k > 0, the
+ * pages of its sub-slots are moved into the sub-slots of level k - 1 by
+ * their expiration tick. At every tick, the sub-slot of level 0 of that
+ * tick is moved into the list of the ring that is expired next, so
+ * descriptors in the wheel expire exactly when they would in the ring.
  */
 typedef struct descriptor_buffer descriptor_buffer_t;
 
 struct descriptor_buffer {
-    descriptor_page_list_t not_expired[SCM_MAX_EXPIRATION_EXTENSION + 2];
+    descriptor_page_list_t *not_expired;
 
     // The field not_expired_length may have the following values:
     //		0 : indicates that the descriptor buffer is unused
-    //		SCM_MAX_EXPIRATION_EXTENSION + 1 : indicates that the descriptor
-    //				buffer is used with a thread-local clock, and
-    //		SCM_MAX_EXPIRATION_EXTENSION + 2 : indicates that the descriptor
-    //				buffer is used with the global clock.
+    //		otherwise : the length of the ring, which is a power of two
     unsigned int not_expired_length;
 
     // current_index is an index to the descriptor_page_list in
@@ -94,23 +151,136 @@ struct descriptor_buffer {
     // Initially, all descriptor buffers but the first one are zombies
     // (because register thread increments descriptor_root->current_time)
     unsigned int age;
+
+#if defined(SCM_REFRESH_COALESCING) || defined(SCM_TIMING_WHEEL)
+    // the number of times the buffer was ticked
+    unsigned long ticks;
+#endif
+
+#ifdef SCM_TIMING_WHEEL
+    // SCM_TIMING_WHEEL_LEVELS levels of SCM_TIMING_WHEEL_SLOTS slots of
+    // SCM_TIMING_WHEEL_SLOTS sub-slot lists, allocated when the first
+    // descriptor is inserted beyond the ring
+    descriptor_page_list_t *wheel;
+#endif
 };
 
-// The max. amount of memory that fits into a region page
-#define SCM_REGION_PAGE_PAYLOAD_SIZE \
-    (SCM_REGION_PAGE_SIZE - sizeof(region_page_t*))
+#ifdef SCM_TIMING_WHEEL
+#if (SCM_TIMING_WHEEL_SLOTS & (SCM_TIMING_WHEEL_SLOTS - 1)) != 0 \
+    || SCM_TIMING_WHEEL_SLOTS < 2
+#error "SCM_TIMING_WHEEL_SLOTS must be a power of two greater than 1"
+#endif
+
+// log2 of the number of slots per level
+#define TIMING_WHEEL_SLOT_BITS __builtin_ctz(SCM_TIMING_WHEEL_SLOTS)
+
+// the number of sub-slot lists per level
+#define TIMING_WHEEL_LISTS (SCM_TIMING_WHEEL_SLOTS * SCM_TIMING_WHEEL_SLOTS)
+
+// The sub-slot list of a level for the expiration tick _tick, whose
+// sub-slots span SCM_TIMING_WHEEL_SLOTS^_level ticks each
+#define TIMING_WHEEL_LIST(_buffer, _level, _tick) \
+    (&(_buffer)->wheel[(_level) * TIMING_WHEEL_LISTS \
+        + (((_tick) >> ((_level) * TIMING_WHEEL_SLOT_BITS)) \
+            & (TIMING_WHEEL_LISTS - 1))])
+#endif
+
+#ifdef SCM_REFRESH_COALESCING
+/*
+ * An entry of the refresh cache remembers that the object has a descriptor
+ * in the buffer of a clock that expires after the clock reaches
+ * the tick count expiration. Refreshes that do not extend the
+ * expiration of the object are coalesced with that descriptor.
+ */
+typedef struct refresh_cache_entry refresh_cache_entry_t;
+
+struct refresh_cache_entry {
+    object_header_t* object;
+    unsigned int clock;
+    unsigned long expiration;
+};
+
+#if (SCM_REFRESH_CACHE_SIZE & (SCM_REFRESH_CACHE_SIZE - 1)) != 0
+#error "SCM_REFRESH_CACHE_SIZE must be a power of two"
+#endif
+
+#define REFRESH_CACHE_INDEX(_object, _clock) \
+    ((((uintptr_t) (_object) >> 3) ^ (_clock)) & (SCM_REFRESH_CACHE_SIZE - 1))
+#endif
+
+// The number of region page sizes. Region pages of order k are
+// SCM_REGION_PAGE_SIZE << k bytes large.
+#define REGION_PAGE_ORDERS (SCM_REGION_PAGE_MAX_ORDER + 1)
+
+#define REGION_PAGE_SIZE(_order) ((size_t) SCM_REGION_PAGE_SIZE << (_order))
+
+// The size of the fields of a region page in front of its memory
+#define REGION_PAGE_HEADER_SIZE offsetof(region_page_t, memory)
+
+// The max. amount of memory that fits into a region page of order _order
+#define REGION_PAGE_PAYLOAD_SIZE(_order) \
+    (REGION_PAGE_SIZE(_order) - REGION_PAGE_HEADER_SIZE)
+
+#if SCM_REGION_PAGE_SIZE > (UINT_MAX >> SCM_REGION_PAGE_MAX_ORDER)
+#error "Region pages must be smaller than 4GB"
+#endif
+
+// The region_object_size of objects in oversized pages, which record the
+// size of their object in the page
+#define OVERSIZED_REGION_OBJECT UINT_MAX
 
 /**
  * region_page contains a pointer to the next region_page,
- * and a chunk of memory for allocating memory objects.
+ * the order of its size, and a chunk of memory for allocating memory
+ * objects.
  * region_page is allocated page-aligned.
+ *
+ * Region pages are not zeroed when they are handed out. The memory of a
+ * page behind dirty_end has never been written since it was last zeroed,
+ * so only memory in front of dirty_end is zeroed when it is allocated again.
+ *
+ * Objects in region pages record their size in the region_object_size
+ * field of their object header, which takes the place of the finalizer
+ * index and allocator that region objects do not have.
+ *
+ * With SCM_HEADERLESS_REGIONS, region pages are units of the region page
+ * arena, which are aligned to the size of the largest region page, and
+ * start with an object header that is tagged with the region id. Region
+ * objects have no header of their own, OBJECT_HEADER() masks their address
+ * to find the header of the page.
  */
 typedef struct region_page region_page_t;
 
 struct region_page {
+#ifdef SCM_HEADERLESS_REGIONS
+    object_header_t header;
+#endif
     region_page_t* nextPage;
-    
-    char memory[SCM_REGION_PAGE_PAYLOAD_SIZE];
+
+    unsigned long order;
+
+    void* dirty_end;
+
+    char memory[];
+};
+
+/**
+ * Objects that do not fit into a region page are allocated in oversized
+ * pages of their own, which are linked into the region and recycled
+ * together with the region. The object header and payload of the object
+ * follow the oversized page header. The object always has an object header
+ * because oversized pages are not part of the region page arena.
+ */
+typedef struct oversized_page oversized_page_t;
+
+struct oversized_page {
+    oversized_page_t* next;
+
+    // the size of the oversized page including this header
+    size_t size;
+
+    // the size of the object in the page
+    size_t object_size;
 };
 
 /**
@@ -127,6 +297,20 @@ struct region_page {
  * The last_address_in_last_page pointer points to the last address in the
  * last region page. The next_free_address pointer can never point to an 
  * address behind the last_address_in_last_page pointer.
+ *
+ * The last_object pointer points to the payload of the most recent
+ * allocation in the last region page, which can be resized in place,
+ * and last_object_size is its size.
+ *
+ * New region pages are of order page_order. Each new page increments
+ * page_order up to max_page_order, so the pages of a region grow
+ * geometrically. Regions with a fixed page size have
+ * page_order == max_page_order.
+ *
+ * The oversized_pages list holds the objects of the region that do not
+ * fit into a region page.
+ *
+ * Objects of regions with zero_memory set are zeroed on allocation.
  */
 typedef struct region region_t;
 
@@ -142,8 +326,42 @@ struct region {
 
     void* next_free_address;
     void* last_address_in_last_page;
+
+    void* last_object;
+    size_t last_object_size;
+
+    unsigned int page_order;
+    unsigned int max_page_order;
+
+    oversized_page_t* oversized_pages;
+
+    bool zero_memory;
+};
+
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+/**
+ * The size of a page pool follows the demand for pages per tick. demand
+ * counts the pages handed out since the last tick, peak_demand is a high
+ * watermark of the demand per tick that decays over time, and limit is the
+ * resulting max. number of pooled pages.
+ */
+typedef struct page_pool_sizing page_pool_sizing_t;
+
+struct page_pool_sizing {
+    unsigned long demand;
+    unsigned long peak_demand;
+    unsigned long limit;
 };
 
+#define DESCRIPTOR_PAGE_POOL_LIMIT \
+    (descriptor_root->descriptor_page_pool_sizing.limit)
+#define REGION_PAGE_POOL_LIMIT(_order) \
+    (descriptor_root->region_page_pool_sizing[_order].limit)
+#else
+#define DESCRIPTOR_PAGE_POOL_LIMIT SCM_DESCRIPTOR_PAGE_FREELIST_SIZE
+#define REGION_PAGE_POOL_LIMIT(_order) SCM_REGION_PAGE_FREELIST_SIZE
+#endif
+
 /**
  * Descriptor root holds thread-local data for descriptor
  * and region management.
@@ -188,15 +406,91 @@ struct descriptor_root {
     // thread participates in global time protocol if flag is false
     bool blocked;
 
-    // A pool of descriptor pages for re-use.
-    descriptor_page_t* descriptor_page_pool[SCM_DESCRIPTOR_PAGE_FREELIST_SIZE];
+#ifdef SCM_BIASED_COUNTING
+    // The owner id of objects allocated by the thread, or 0 if the
+    // objects of the thread are always counted atomically.
+    unsigned int owner_id;
+    // Objects of the thread whose atomically counted descriptors expired,
+    // pushed by other threads and linked through their merge_next field.
+    // The thread frees them if it counts no descriptors of the object
+    // either.
+    object_header_t* volatile merge_queue;
+#endif
+
+#ifdef SCM_SHARDED_COUNTERS
+    // The shard in which the thread counts descriptors of sharded objects.
+    unsigned int counter_shard;
+#endif
+
+#ifdef SCM_COLLECTION_PACER
+    // The number of objects the thread allocated since the last
+    // collection step of the pacer.
+    unsigned long pacer_allocations;
+#endif
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+    // Expired object descriptor pages the thread handed over to the
+    // reclaimer, linked through their next field.
+    descriptor_page_t* volatile handed_over_pages;
+    // The next root in the queue of the reclaimer, valid while queued.
+    descriptor_root_t *next_to_reclaim;
+    volatile int queued;
+    // reclaiming is set while the reclaimer processes pages of the thread.
+    // Both are protected by reclaim_lock, reclaimed is signaled when the
+    // reclaimer is done.
+    bool reclaiming;
+    pthread_mutex_t reclaim_lock;
+    pthread_cond_t reclaimed;
+    // Descriptor pages the reclaimer processed, to be recycled by the thread.
+    descriptor_page_t* volatile reclaimed_pages;
+#endif
+
+#ifdef SCM_REFRESH_COALESCING
+    // The most recent refreshes of objects with a thread-local clock.
+    refresh_cache_entry_t refresh_cache[SCM_REFRESH_CACHE_SIZE];
+#endif
+
+    // A pool of descriptor pages for re-use, linked through their next field.
+    descriptor_page_t* descriptor_page_pool;
     unsigned long number_of_pooled_descriptor_pages;
 
     region_t regions[SCM_MAX_REGIONS];
     unsigned int next_reg_index;
 
-    region_page_t* region_page_pool;
-    unsigned long number_of_pooled_region_pages;
+    // Pools of region pages for re-use, one per region page size.
+    region_page_t* region_page_pool[REGION_PAGE_ORDERS];
+    unsigned long number_of_pooled_region_pages[REGION_PAGE_ORDERS];
+
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+    // The limits of the descriptor and region page pools.
+    page_pool_sizing_t descriptor_page_pool_sizing;
+    page_pool_sizing_t region_page_pool_sizing[REGION_PAGE_ORDERS];
+#endif
+
+    // A pool of oversized pages of expired regions for re-use.
+    oversized_page_t* oversized_page_pool;
+    unsigned long number_of_pooled_oversized_pages;
+
+#ifdef SCM_SLAB_ALLOCATION
+    // The size classes of the thread-local slab allocator.
+    slab_class_t slab_classes[SLAB_NUMBER_OF_CLASSES];
+#endif
+
+#ifdef SCM_HEADERLESS_OBJECTS
+    // The size classes of the thread-local headerless allocator.
+    span_class_t span_classes[SPAN_NUMBER_OF_CLASSES];
+#endif
+
+#ifdef SCM_PAGE_CHUNKS
+    // The chunk that descriptor and region pages are carved from.
+    page_chunk_allocator_t page_chunks;
+#endif
+
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+    // A pool of mappings of expired large objects for re-use.
+    large_object_t* large_object_pool;
+    unsigned long number_of_pooled_large_objects;
+#endif
 
     // Singly-linked list of terminated descriptor_roots.
     // This is only used after the thread terminated.
@@ -205,7 +499,277 @@ struct descriptor_root {
 
 extern __thread descriptor_root_t* descriptor_root;
 
-inline void increment_current_index(descriptor_buffer_t *buffer)
+#ifdef SCM_HEADERLESS_REGIONS
+/*
+ * tag_region_page() initializes the object header of a region page, which
+ * is shared by all objects of the page, with the id of the region.
+ */
+static inline void tag_region_page(region_page_t *page, region_t *region) {
+    page->header.dc_or_region_id =
+        (int) (region - descriptor_root->regions) | HB_MASK;
+    page->header.finalizer_index = -1;
+    page->header.allocator = OBJECT_ALLOCATOR_MALLOC;
+}
+
+#endif
+
+#if defined(SCM_HEADERLESS_REGIONS) || defined(SCM_REGION_PAGE_CHUNKS)
+#define REGION_PAGE_USABLE_SIZE(_page) REGION_PAGE_SIZE((_page)->order)
+#else
+#define REGION_PAGE_USABLE_SIZE(_page) __real_malloc_usable_size(_page)
+#endif
+
+#ifdef SCM_DESCRIPTOR_PAGE_CHUNKS
+#define DESCRIPTOR_PAGE_USABLE_SIZE(_page) SCM_DESCRIPTOR_PAGE_SIZE
+#else
+#define DESCRIPTOR_PAGE_USABLE_SIZE(_page) __real_malloc_usable_size(_page)
+#endif
+
+/*
+ * mark_region_page_dirty() raises the dirty_end of the last page of a region
+ * to the end of the memory allocated in the page so far.
+ */
+static inline void mark_region_page_dirty(region_t *region) {
+    region_page_t *page = region->lastPage;
+
+    if (page == NULL) {
+        return;
+    }
+
+    void *used = region->next_free_address < region->last_address_in_last_page ?
+        region->next_free_address : region->last_address_in_last_page;
+
+    if (used > page->dirty_end) {
+        page->dirty_end = used;
+    }
+}
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+/* reclaim_expired_objects()
+ * expires the object descriptors in a list of pages that
+ * a thread handed over and gives the pages back to it */
+void reclaim_expired_objects(descriptor_root_t *root, descriptor_page_t *first)
+    __attribute__((visibility("hidden")));
+
+/* recycle_reclaimed_descriptor_pages()
+ * recycles the pages the reclaimer gave back to the calling thread */
+void recycle_reclaimed_descriptor_pages(void)
+    __attribute__((visibility("hidden")));
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+/* register_owner()
+ * assigns an owner id to a new descriptor root,
+ * unless SCM_MAX_BIASED_OWNERS ids are taken */
+void register_owner(descriptor_root_t *root)
+    __attribute__((visibility("hidden")));
+
+/* queue_for_merge()
+ * pushes an object onto the merge queue of its owner */
+void queue_for_merge(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/* merge_queued_objects()
+ * frees the objects in the merge queue of the calling
+ * thread that have no descriptors anymore */
+void merge_queued_objects(void)
+    __attribute__((visibility("hidden")));
+
+/*
+ * is_biased() returns true iff the calling thread counts descriptors of the
+ * object in biased_dc.
+ */
+static inline bool is_biased(object_header_t *object) {
+    //merged objects, e.g. headerless objects, may not have an owner field
+    return !(object->dc_or_region_id & DC_MERGED)
+        && object->owner == descriptor_root->owner_id;
+}
+#endif
+
+/*
+ * init_descriptor_counter() initializes the descriptor counter of a new
+ * object without descriptors, which is owned by the calling thread.
+ */
+static inline void init_descriptor_counter(object_header_t *object) {
+#ifdef SCM_COLLECTION_PACER
+    //new objects set the pace of collection
+    if (descriptor_root != NULL) {
+        descriptor_root->pacer_allocations++;
+    }
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+#ifdef SCM_HEADERLESS_OBJECTS
+    if (is_headerless(object)) {
+        //side headers have no room for biased counters
+        object->dc_or_region_id = DC_MERGED;
+        return;
+    }
+#endif
+
+    object->biased_dc = 0;
+
+    if (descriptor_root != NULL && descriptor_root->owner_id != 0) {
+        object->owner = descriptor_root->owner_id;
+        object->dc_or_region_id = 0;
+    } else {
+        //objects without owner are merged from the start
+        object->owner = 0;
+        object->dc_or_region_id = DC_MERGED;
+    }
+#else
+    object->dc_or_region_id = 0;
+#endif
+}
+
+/*
+ * has_descriptors() returns true iff descriptors of an object that is not
+ * allocated in a region exist.
+ */
+static inline bool has_descriptors(object_header_t *object) {
+#ifdef SCM_BIASED_COUNTING
+    int dc = object->dc_or_region_id;
+
+    //merged objects do not count descriptors in biased_dc anymore
+    return (dc & (DC_COUNT_MASK | DC_QUEUED)) != 0
+        || (!(dc & DC_MERGED) && object->biased_dc != 0);
+#else
+    return object->dc_or_region_id != 0;
+#endif
+}
+
+/*
+ * is_descriptor_counter_full() returns true iff the calling thread cannot
+ * count another descriptor of an object that is not allocated in a region.
+ */
+static inline bool is_descriptor_counter_full(object_header_t *object) {
+#ifdef SCM_SHARDED_COUNTERS
+    if (get_object_allocator(object) == OBJECT_ALLOCATOR_SHARDED) {
+        return COUNTER_SHARDS(object)[descriptor_root->counter_shard].count
+            == INT_MAX;
+    }
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+    if (is_biased(object)) {
+        return object->biased_dc == DC_COUNT_MASK;
+    }
+
+    return (object->dc_or_region_id & DC_COUNT_MASK) == DC_COUNT_MASK;
+#else
+    return object->dc_or_region_id == INT_MAX;
+#endif
+}
+
+/*
+ * increment_descriptor_counter() counts a new descriptor of an object that
+ * is not allocated in a region.
+ */
+static inline void increment_descriptor_counter(object_header_t *object) {
+#ifdef SCM_SHARDED_COUNTERS
+    if (get_object_allocator(object) == OBJECT_ALLOCATOR_SHARDED) {
+        increment_sharded_counter(object, descriptor_root->counter_shard);
+        return;
+    }
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+    if (is_biased(object)) {
+        object->biased_dc++;
+        return;
+    }
+#endif
+
+    atomic_int_inc((int*) &object->dc_or_region_id);
+}
+
+/*
+ * decrement_descriptor_counter_and_test() uncounts an expired descriptor of
+ * an object and returns true iff the object has no descriptors anymore and
+ * must be freed by the calling thread.
+ */
+static inline bool decrement_descriptor_counter_and_test(object_header_t *object) {
+#ifdef SCM_SHARDED_COUNTERS
+    if (get_object_allocator(object) == OBJECT_ALLOCATOR_SHARDED) {
+        return decrement_sharded_counter_and_test(object,
+                                                  descriptor_root->counter_shard);
+    }
+#endif
+
+#ifdef SCM_BIASED_COUNTING
+    volatile int *dc = &object->dc_or_region_id;
+
+    if (is_biased(object)) {
+        if (--object->biased_dc > 0) {
+            return false;
+        }
+
+        if (*dc == 0) {
+            //no other thread counts descriptors of the object
+            return true;
+        }
+
+        //count atomically from now on
+        return atomic_int_exchange_and_add(dc, DC_MERGED) == 0;
+    }
+
+    while (true) {
+        int old_dc = *dc;
+
+        if ((old_dc & (DC_MERGED | DC_COUNT_MASK)) != 1) {
+            //the object is merged or still has atomically counted descriptors
+            return atomic_int_exchange_and_add(dc, -1) == DC_MERGED + 1;
+        }
+
+        //the owner may still count descriptors of the object, so it
+        //decides whether the object is freed
+        if (atomic_int_compare_and_exchange(dc, old_dc, DC_QUEUED) == old_dc) {
+            if (!(old_dc & DC_QUEUED)) {
+                queue_for_merge(object);
+            }
+
+            return false;
+        }
+    }
+#else
+    return atomic_int_dec_and_test((int*) &object->dc_or_region_id);
+#endif
+}
+
+#ifdef SCM_TIMING_WHEEL
+/* cascade_timing_wheel()
+ * moves the slots of the timing wheel of a descriptor
+ * buffer that start at the current tick one level down
+ * and the pages that expire at the current tick into the
+ * ring list that is expired next */
+void cascade_timing_wheel(descriptor_buffer_t *buffer)
+    __attribute__((visibility("hidden")));
+#endif
+
+/**
+ * Increments the current_index modulo the length of the ring.
+ */
+static inline void increment_current_index(descriptor_buffer_t *buffer) {
+    buffer->current_index =
+        (buffer->current_index + 1) & (buffer->not_expired_length - 1);
+
+#if defined(SCM_REFRESH_COALESCING) || defined(SCM_TIMING_WHEEL)
+    buffer->ticks++;
+#endif
+
+#ifdef SCM_TIMING_WHEEL
+    if (buffer->wheel != NULL) {
+        cascade_timing_wheel(buffer);
+    }
+#endif
+}
+
+/* reserve_descriptor_buffer()
+ * allocates or grows the ring of a descriptor buffer so
+ * that descriptors can be inserted max_expiration ticks
+ * ahead of the current time */
+void reserve_descriptor_buffer(descriptor_buffer_t *buffer,
+                               unsigned int max_expiration)
     __attribute__((visibility("hidden")));
 
 /* Takes an object or a region as parameter ptr */
@@ -213,6 +777,11 @@ void insert_descriptor(void* ptr,
                        descriptor_buffer_t *buffer, unsigned int expiration)
     __attribute__((visibility("hidden")));
 
+/* Takes n objects or regions as parameter ptrs */
+void insert_descriptors(void** ptrs, unsigned long n,
+                        descriptor_buffer_t *buffer, unsigned int expiration)
+    __attribute__((visibility("hidden")));
+
 /* Expires the descriptor buffer by appending
  * the just-expired descriptors to the
  * list_of_expired_[obj|reg]_descriptors. */
@@ -230,4 +799,26 @@ int expire_object_descriptor_if_exists(expired_descriptor_page_list_t *list)
 int expire_region_descriptor_if_exists(expired_descriptor_page_list_t *list)
     __attribute__((visibility("hidden")));
 
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+/* init_page_pools()
+ * sets the limits of the page pools of a new
+ * descriptor root to their compile-time sizes */
+void init_page_pools(descriptor_root_t *root)
+    __attribute__((visibility("hidden")));
+
+/* resize_page_pools()
+ * adapts the limits of the page pools to the demand
+ * since the last call and trims the pools to their limits */
+void resize_page_pools(void)
+    __attribute__((visibility("hidden")));
+#endif
+
+#ifdef SCM_PAGE_DEPOT
+/* refill_region_page_pool()
+ * refills the empty region page pool of the given order
+ * with a magazine from the depot, if available */
+void refill_region_page_pool(unsigned int order)
+    __attribute__((visibility("hidden")));
+#endif
+
 #endif	/* _DESCRIPTORS_H_ */
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "libscm.h"
+
+#define OBJECTS 100
+
+static int finalized = 0;
+
+int count_finalized(void *ptr) {
+	finalized++;
+	return 0;
+}
+
+void check(int condition, const char *message) {
+	if (!condition) {
+		printf("prog10: %s\n", message);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+
+	void *objects[OBJECTS];
+	int i;
+
+	const int finalizer = scm_register_finalizer(count_finalized);
+
+	for (i = 0; i < OBJECTS; i++) {
+		objects[i] = scm_malloc(16);
+		scm_set_finalizer(objects[i], finalizer);
+		scm_refresh(objects[i], 0);
+	}
+
+	scm_tick();
+
+	//each collected descriptor frees at most one object
+	int before = finalized;
+	size_t left = scm_collect_n(OBJECTS / 4);
+
+	check(finalized - before <= OBJECTS / 4, "scm_collect_n collected too much");
+
+	while (left > 0) {
+		size_t next = scm_collect_n(10);
+
+		check(next < left, "scm_collect_n made no progress");
+		left = next;
+	}
+
+	check(scm_collect_for_ns(1000000) == 0, "scm_collect_for_ns left work");
+
+	scm_collect();
+	check(finalized == OBJECTS, "bounded collection missed objects");
+
+	printf("prog10: success!\n");
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "libscm.h"
+
+//prog11 lets a thread expire the last descriptor of an object that the
+//main thread allocated while both threads only tick globally. With
+//SCM_BIASED_COUNTING the object is queued for the main thread, which
+//frees it at its next global tick.
+
+//globally refreshed objects expire two global periods after their
+//extension, the thread that joins last starts ticking a period later
+#define ROUNDS 4
+
+static pthread_barrier_t barrier;
+static void *object;
+static int finalized = 0;
+
+int count_finalized(void *ptr) {
+	__sync_fetch_and_add(&finalized, 1);
+	return 0;
+}
+
+void *refresh_and_collect(void *arg) {
+	int i;
+
+	scm_global_refresh(object, 0);
+	pthread_barrier_wait(&barrier);
+
+	for (i = 0; i < ROUNDS; i++) {
+		scm_global_tick();
+		pthread_barrier_wait(&barrier);
+	}
+
+	scm_collect();
+	pthread_barrier_wait(&barrier);
+
+	return NULL;
+}
+
+int main(int argc, char** argv) {
+
+	pthread_t thread;
+	int i;
+
+	const int finalizer = scm_register_finalizer(count_finalized);
+
+	//objects are owned by threads that use libscm already
+	scm_create_region();
+
+	object = scm_malloc(16);
+	scm_set_finalizer(object, finalizer);
+
+	pthread_barrier_init(&barrier, NULL, 2);
+	pthread_create(&thread, NULL, refresh_and_collect, NULL);
+
+	pthread_barrier_wait(&barrier);
+
+	for (i = 0; i < ROUNDS; i++) {
+		scm_global_tick();
+		pthread_barrier_wait(&barrier);
+	}
+
+	//the other thread expires the descriptor
+	pthread_barrier_wait(&barrier);
+	pthread_join(thread, NULL);
+
+	scm_global_tick();
+
+	if (finalized != 1) {
+		printf("prog11: finalized=%d\n", finalized);
+		exit(1);
+	}
+
+	printf("prog11: success!\n");
+	return 0;
+}
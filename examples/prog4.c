@@ -0,0 +1,127 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libscm.h"
+
+//prog4 resizes region objects with realloc and must be linked with
+//--wrap realloc
+
+void check(int condition, const char *message) {
+	if (!condition) {
+		printf("prog4: %s\n", message);
+		exit(1);
+	}
+}
+
+int is_filled(const unsigned char *ptr, size_t from, size_t to, unsigned char value) {
+	size_t i;
+
+	for (i = from; i < to; i++) {
+		if (ptr[i] != value) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+int main(int argc, char** argv) {
+
+	const int region = scm_create_region();
+
+	//calloc in a region returns zeroed memory
+	unsigned char *a = scm_malloc_in_region(100, region);
+	unsigned char *b = scm_calloc_in_region(10, 30, region);
+
+	check(a != NULL && b != NULL, "allocation in region failed");
+	check(is_filled(b, 0, 300, 0), "scm_calloc_in_region returned dirty memory");
+
+	memset(a, 'a', 100);
+	memset(b, 'b', 300);
+
+	//a is not the most recent allocation and is copied by its recorded
+	//size. Objects without object header (SCM_HEADERLESS_REGIONS) do not
+	//record their size and are not resized.
+	unsigned char *a2 = realloc(a, 400);
+	const int sizes_recorded = a2 != NULL;
+
+	check(is_filled(b, 0, 300, 'b'), "non-tail realloc overwrote its neighbor");
+
+	if (sizes_recorded) {
+		check(a2 != a, "non-tail region object was not moved");
+		check(is_filled(a2, 0, 100, 'a'), "non-tail realloc lost the payload");
+		check(is_filled(a2, 100, 400, 0), "non-tail realloc did not zero the growth");
+	} else {
+		check(is_filled(a, 0, 100, 'a'), "failed realloc lost the payload");
+		a2 = scm_malloc_in_region(400, region);
+	}
+
+	//a2 is the most recent allocation and is resized in place
+	memset(a2, 'c', 400);
+
+	unsigned char *a3 = realloc(a2, 1000);
+
+	check(a3 == a2, "tail region object was not resized in place");
+	check(is_filled(a3, 0, 400, 'c'), "tail realloc lost the payload");
+	check(is_filled(a3, 400, 1000, 0), "tail realloc did not zero the growth");
+
+	//shrinking and growing again zeroes the regrown tail
+	a3 = realloc(a3, 50);
+	a3 = realloc(a3, 500);
+
+	check(is_filled(a3, 0, 50, 'c'), "shrink and grow lost the payload");
+	check(is_filled(a3, 50, 500, 0), "shrink and grow did not zero the tail");
+
+	//copies of aligned region objects keep their alignment
+	unsigned char *c = scm_malloc_in_region_aligned(64, 256, region);
+
+	check(c != NULL && ((uintptr_t) c & 255) == 0,
+		"scm_malloc_in_region_aligned returned a misaligned object");
+	memset(c, 'd', 64);
+
+	scm_malloc_in_region(8, region);
+
+	unsigned char *c2 = realloc(c, 2000);
+
+	if (sizes_recorded) {
+		check(c2 != NULL && ((uintptr_t) c2 & 255) == 0, "realloc lost the alignment");
+		check(is_filled(c2, 0, 64, 'd'), "aligned realloc lost the payload");
+		check(is_filled(c2, 64, 2000, 0), "aligned realloc did not zero the growth");
+	}
+
+	//small copies of objects at large alignments are placed right behind
+	//the last allocation of a region with enough room in its page
+	const int fresh_region = scm_create_region();
+	unsigned char *far_aligned = scm_malloc_in_region_aligned(64, 1024, fresh_region);
+	unsigned char *behind = scm_malloc_in_region(8, fresh_region);
+	unsigned char *copy = realloc(far_aligned, 100);
+
+	check(!sizes_recorded || (copy > behind && copy < behind + 256),
+		"realloc kept the alignment of a small object");
+
+	//objects larger than a region page are resized, too
+	unsigned char *large = scm_malloc_in_region(100000, region);
+
+	memset(large, 'e', 100000);
+	scm_malloc_in_region(8, region);
+
+	unsigned char *large2 = realloc(large, 200000);
+
+	check(is_filled(large2, 0, 100000, 'e'), "oversized realloc lost the payload");
+	check(is_filled(large2, 100000, 200000, 0),
+		"oversized realloc did not zero the growth");
+
+	//memory of a recycled region is zeroed again
+	scm_refresh_region(region, 0);
+	scm_tick();
+	scm_collect();
+
+	unsigned char *d = scm_calloc_in_region(1, 1000, region);
+
+	check(is_filled(d, 0, 1000, 0), "recycled region memory is dirty");
+
+	printf("prog4: success!\n");
+	return 0;
+}
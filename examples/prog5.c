@@ -0,0 +1,63 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libscm.h"
+
+#define ROUNDS 10
+#define REGION_ROUNDS 5
+
+static int finalized = 0;
+
+int count_finalized(void *ptr) {
+	finalized++;
+	return 0;
+}
+
+void check(int condition, const char *message) {
+	if (!condition) {
+		printf("prog5: %s\n", message);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+
+	int i;
+
+	const int finalizer = scm_register_finalizer(count_finalized);
+	const int region = scm_create_region();
+
+	//aligned objects expire like other objects
+	for (i = 0; i < ROUNDS; i++) {
+		size_t alignment = (size_t) 16 << i;
+		void *aligned = scm_malloc_aligned(100, alignment);
+
+		check(aligned != NULL, "scm_malloc_aligned failed");
+		check(((uintptr_t) aligned & (alignment - 1)) == 0,
+			"scm_malloc_aligned returned a misaligned object");
+		memset(aligned, i, 100);
+
+		scm_set_finalizer(aligned, finalizer);
+		scm_refresh(aligned, 0);
+	}
+
+	//aligned region objects fit into region pages
+	for (i = 0; i < REGION_ROUNDS; i++) {
+		size_t alignment = (size_t) 16 << i;
+		void *in_region = scm_malloc_in_region_aligned(100, alignment, region);
+
+		check(in_region != NULL, "scm_malloc_in_region_aligned failed");
+		check(((uintptr_t) in_region & (alignment - 1)) == 0,
+			"scm_malloc_in_region_aligned returned a misaligned object");
+		memset(in_region, i, 100);
+	}
+
+	scm_tick();
+	scm_collect();
+	check(finalized == ROUNDS, "aligned objects did not expire");
+
+	printf("prog5: success!\n");
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "libscm.h"
+
+#define OBJECTS 100
+
+static int finalized = 0;
+
+int count_finalized(void *ptr) {
+	finalized++;
+	return 0;
+}
+
+void tick_and_collect(int ticks) {
+	int i;
+
+	for (i = 0; i < ticks; i++) {
+		scm_tick();
+		scm_collect();
+	}
+}
+
+void check(int condition, const char *message) {
+	if (!condition) {
+		printf("prog6: %s\n", message);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+
+	void *objects[OBJECTS];
+	int regions[2];
+	int i;
+
+	const int finalizer = scm_register_finalizer(count_finalized);
+
+	//refresh all objects in one batch, NULL pointers are skipped
+	for (i = 0; i < OBJECTS; i++) {
+		objects[i] = scm_malloc(16);
+		scm_set_finalizer(objects[i], finalizer);
+	}
+	objects[OBJECTS / 2] = NULL;
+
+	scm_refresh_many(objects, OBJECTS, 1, 0);
+
+	tick_and_collect(1);
+	check(finalized == 0, "objects of scm_refresh_many expired early");
+
+	tick_and_collect(1);
+	check(finalized == OBJECTS - 1, "objects of scm_refresh_many did not expire");
+
+	//regions refreshed in one batch are recycled after the extension
+	regions[0] = scm_create_region();
+	regions[1] = scm_create_region();
+
+	void *first = scm_malloc_in_region(64, regions[1]);
+
+	scm_refresh_region_many(regions, 2, 0, 0);
+
+	tick_and_collect(1);
+	check(scm_malloc_in_region(64, regions[1]) == first,
+		"region of scm_refresh_region_many was not recycled");
+
+	printf("prog6: success!\n");
+	return 0;
+}
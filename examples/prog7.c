@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libscm.h"
+
+#define OBJECTS 100
+
+static int finalized = 0;
+
+int count_finalized(void *ptr) {
+	finalized++;
+	return 0;
+}
+
+void tick_and_collect(int ticks) {
+	int i;
+
+	for (i = 0; i < ticks; i++) {
+		scm_tick();
+		scm_collect();
+	}
+}
+
+void check(int condition, const char *message) {
+	if (!condition) {
+		printf("prog7: %s\n", message);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+
+	void *objects[OBJECTS];
+	int i;
+
+	const int finalizer = scm_register_finalizer(count_finalized);
+
+	//allocate and refresh at once, the objects live for 3 ticks
+	for (i = 0; i < OBJECTS; i++) {
+		objects[i] = scm_malloc_refreshed(16, 2, 0);
+		check(objects[i] != NULL, "scm_malloc_refreshed failed");
+		scm_set_finalizer(objects[i], finalizer);
+	}
+
+	tick_and_collect(2);
+	check(finalized == 0, "refreshed objects expired early");
+
+	tick_and_collect(1);
+	check(finalized == OBJECTS, "refreshed objects did not expire");
+
+	//a region refreshed at allocation is recycled after the extension
+	const int region = scm_create_region();
+	void *first = scm_malloc_in_region_refreshed(64, region, 1, 0);
+
+	check(first != NULL, "scm_malloc_in_region_refreshed failed");
+	memset(first, 1, 64);
+
+	tick_and_collect(1);
+	check(scm_malloc_in_region(64, region) != first,
+		"region was recycled early");
+
+	tick_and_collect(1);
+	check(scm_malloc_in_region(64, region) == first,
+		"region was not recycled");
+
+	printf("prog7: success!\n");
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libscm.h"
+
+#define OBJECTS 100
+
+static int finalized = 0;
+
+int count_finalized(void *ptr) {
+	finalized++;
+	return 0;
+}
+
+void tick_and_collect(int ticks) {
+	int i;
+
+	for (i = 0; i < ticks; i++) {
+		scm_tick();
+		scm_collect();
+	}
+}
+
+void check(int condition, const char *message) {
+	if (!condition) {
+		printf("prog8: %s\n", message);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+
+	void *objects[OBJECTS];
+	int i;
+
+	const int finalizer = scm_register_finalizer(count_finalized);
+
+	//sharded objects live as long as their longest refresh
+	for (i = 0; i < OBJECTS; i++) {
+		objects[i] = scm_malloc_sharded(100);
+		check(objects[i] != NULL, "scm_malloc_sharded failed");
+		memset(objects[i], i, 100);
+		scm_set_finalizer(objects[i], finalizer);
+		scm_refresh(objects[i], 0);
+		scm_refresh(objects[i], 1);
+	}
+
+	tick_and_collect(1);
+	check(finalized == 0, "sharded objects expired early");
+
+	tick_and_collect(1);
+	check(finalized == OBJECTS, "sharded objects did not expire");
+
+	//reallocated sharded objects are ordinary objects
+	void *object = scm_malloc_sharded(100);
+
+	memset(object, 'a', 100);
+	object = realloc(object, 1000);
+	check(object != NULL, "realloc of sharded object failed");
+	scm_set_finalizer(object, finalizer);
+	scm_refresh(object, 0);
+
+	tick_and_collect(1);
+	check(finalized == OBJECTS + 1, "reallocated sharded object did not expire");
+
+	printf("prog8: success!\n");
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "libscm.h"
+
+//prog9 checks that objects with long expiration extensions expire at
+//exactly the tick their extension ends, also when the descriptors are
+//kept in a timing wheel (SCM_TIMING_WHEEL)
+
+#define MAX_EXTENSION 10000
+
+static const unsigned int extensions[] = {
+	0, 1, 63, 64, 65, 127, 128, 200, 4095, 4096, 4097, 5000, MAX_EXTENSION
+};
+
+#define OBJECTS (sizeof(extensions) / sizeof(extensions[0]))
+
+static void *objects[OBJECTS];
+static int expired_at[OBJECTS];
+static int current_tick = 0;
+
+int record_expiration(void *ptr) {
+	unsigned int i;
+
+	for (i = 0; i < OBJECTS; i++) {
+		if (objects[i] == ptr) {
+			expired_at[i] = current_tick;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv) {
+
+	unsigned int i;
+	int start;
+
+	const int finalizer = scm_register_finalizer(record_expiration);
+
+	scm_set_max_expiration_extension(MAX_EXTENSION);
+
+	//refresh at ticks that are not aligned to slots of the timing wheel
+	for (start = 0; start < 3; start++) {
+		int t;
+
+		for (t = 0; t < 10 + start * 53; t++) {
+			scm_tick();
+		}
+
+		for (i = 0; i < OBJECTS; i++) {
+			objects[i] = scm_malloc(16);
+			expired_at[i] = -1;
+			scm_set_finalizer(objects[i], finalizer);
+			scm_refresh(objects[i], extensions[i]);
+		}
+
+		//an object refreshed with extension n expires at the n + 1st tick
+		for (current_tick = 1; current_tick <= MAX_EXTENSION + 1; current_tick++) {
+			scm_tick();
+			scm_collect();
+		}
+
+		for (i = 0; i < OBJECTS; i++) {
+			if (expired_at[i] != (int) extensions[i] + 1) {
+				printf("prog9: extension %u expired at tick %d\n",
+					extensions[i], expired_at[i]);
+				exit(1);
+			}
+		}
+	}
+
+	printf("prog9: success!\n");
+	return 0;
+}
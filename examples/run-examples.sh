@@ -4,4 +4,12 @@ export LD_LIBRARY_PATH=../dist
 
 ./prog1
 ./prog2
-./prog3
\ No newline at end of file
+./prog3
+./prog4
+./prog5
+./prog6
+./prog7
+./prog8
+./prog9
+./prog10
+./prog11
\ No newline at end of file
@@ -5,6 +5,8 @@
  * can be found in the LICENSE file.
  */
 
+#include <stdio.h>
+
 #include "finalizer.h"
 
 //finalizer table contains function pointers;
@@ -24,21 +26,32 @@ int scm_register_finalizer(int(*scm_finalizer)(void*)) {
 }
 
 void scm_set_finalizer(void *ptr, int scm_finalizer_id) {
-    //set function index
     object_header_t *o = OBJECT_HEADER(ptr);
-    o->finalizer_index = scm_finalizer_id;
+
+    //region objects are never finalized, their header records their size
+    if (o->dc_or_region_id < 0) {
+#ifdef SCM_DEBUG
+        printf("Region objects have no finalizers.\n");
+#endif
+        return;
+    }
+
+    //set function index
+    *get_finalizer_index(o) = scm_finalizer_id;
 }
 
 
 int run_finalizer(object_header_t *o) {
     //INVARIANT: object o is already expired
 
-    if (o->finalizer_index == -1) return 0; //object has no finalizer
+    short finalizer_index = *get_finalizer_index(o);
+
+    if (finalizer_index == -1) return 0; //object has no finalizer
 
     void *ptr = PAYLOAD_OFFSET(o);
     int (*finalizer)(void*);
     //get function pointer to objects finalizer
-    finalizer = finalizer_table[o->finalizer_index];
+    finalizer = finalizer_table[finalizer_index];
 
     //run finalizer and return the result of it
     return (*finalizer)(ptr);
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+//mremap is a GNU extension
+#define _GNU_SOURCE
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include "descriptors.h"
+
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+
+#ifdef MADV_FREE
+//MADV_FREE requires Linux 4.5, older kernels reject it with EINVAL and
+//the pages are dropped eagerly with MADV_DONTNEED from then on
+static int free_advice = MADV_FREE;
+#else
+static int free_advice = MADV_DONTNEED;
+#endif
+
+static size_t page_size = 0;
+
+static inline size_t get_page_size() {
+    if (page_size == 0) {
+        page_size = sysconf(_SC_PAGESIZE);
+    }
+    return page_size;
+}
+
+#define LARGE_OBJECT(_o) \
+    ((large_object_t*) ((void*)(_o) + sizeof(object_header_t) - get_page_size()))
+#define LARGE_OBJECT_HEADER(_l) \
+    ((object_header_t*) ((void*)(_l) + get_page_size() - sizeof(object_header_t)))
+
+/**
+ * Returns the size of the mapping for a payload of the given size including
+ * the prefix page, or 0 if the size cannot be mapped.
+ */
+static inline size_t get_mapping_size(size_t size) {
+    size_t page = get_page_size();
+
+    if (size > (size_t) -1 - 2 * page) {
+        return 0;
+    }
+
+    return (size + 2 * page - 1) & ~(page - 1);
+}
+
+/**
+ * Remaps a mapping to the given size. Returns NULL if the mapping could not
+ * be remapped, in which case the old mapping is still valid.
+ */
+static large_object_t* remap(large_object_t *mapping, size_t mapping_size) {
+    large_object_t *new_mapping = mremap(mapping, mapping->mapping_size,
+                                         mapping_size, MREMAP_MAYMOVE);
+
+    if (new_mapping == MAP_FAILED) {
+#ifdef SCM_DEBUG
+        printf("Remapping of large object failed.\n");
+#endif
+        return NULL;
+    }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_freed_mem(new_mapping->mapping_size);
+    inc_allocated_mem(mapping_size);
+#endif
+
+    new_mapping->mapping_size = mapping_size;
+
+    return new_mapping;
+}
+
+static void unmap(large_object_t *mapping) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_overhead(get_page_size());
+    inc_freed_mem(mapping->mapping_size);
+#endif
+
+    munmap(mapping, mapping->mapping_size);
+}
+
+/**
+ * Takes a mapping from the large object pool and remaps it to the requested
+ * size, or maps new memory if the pool is empty.
+ */
+object_header_t* large_object_malloc(size_t size) {
+
+    size_t mapping_size = get_mapping_size(size);
+
+    if (mapping_size == 0) {
+        return NULL;
+    }
+
+    large_object_t *mapping = NULL;
+
+    if (descriptor_root != NULL && descriptor_root->large_object_pool != NULL) {
+        large_object_t *pooled = descriptor_root->large_object_pool;
+
+        descriptor_root->large_object_pool = pooled->next;
+        descriptor_root->number_of_pooled_large_objects--;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+        dec_pooled_mem(pooled->mapping_size);
+#endif
+
+        if (pooled->mapping_size == mapping_size) {
+            mapping = pooled;
+        } else {
+            mapping = remap(pooled, mapping_size);
+
+            if (mapping == NULL) {
+                unmap(pooled);
+            }
+        }
+    }
+
+    if (mapping == NULL) {
+        mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (mapping == MAP_FAILED) {
+#ifdef SCM_DEBUG
+            printf("Mapping of large object failed.\n");
+#endif
+            return NULL;
+        }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+        inc_allocated_mem(mapping_size);
+        inc_overhead(get_page_size());
+#endif
+
+        mapping->mapping_size = mapping_size;
+    }
+
+    mapping->next = NULL;
+
+    object_header_t *object = LARGE_OBJECT_HEADER(mapping);
+
+    init_descriptor_counter(object);
+    object->finalizer_index = -1;
+    object->allocator = OBJECT_ALLOCATOR_LARGE;
+
+    return object;
+}
+
+/**
+ * Hands the payload pages of a mapping back to the OS. Returns 0 on success.
+ */
+static int release_pages(large_object_t *mapping) {
+    void *payload = (void*) mapping + get_page_size();
+    size_t payload_size = mapping->mapping_size - get_page_size();
+
+    if (madvise(payload, payload_size, free_advice) == 0) {
+        return 0;
+    }
+
+    if (errno != EINVAL || free_advice == MADV_DONTNEED) {
+#ifdef SCM_DEBUG
+        printf("Pages of large object could not be released.\n");
+#endif
+        return -1;
+    }
+
+    //the kernel does not support MADV_FREE
+    free_advice = MADV_DONTNEED;
+
+    return madvise(payload, payload_size, free_advice);
+}
+
+/**
+ * Pools the mapping of an expired or freed large object. The payload pages
+ * are handed back to the OS lazily with MADV_FREE, or eagerly with
+ * MADV_DONTNEED if the kernel does not support MADV_FREE. Mappings are
+ * unmapped if the pool is full, their pages could not be handed back, or
+ * the calling thread has no descriptor root.
+ */
+void large_object_free(object_header_t *object) {
+
+    large_object_t *mapping = LARGE_OBJECT(object);
+
+    if (descriptor_root == NULL || descriptor_root->number_of_pooled_large_objects
+            >= SCM_LARGE_OBJECT_FREELIST_SIZE || release_pages(mapping) != 0) {
+        unmap(mapping);
+        return;
+    }
+
+    mapping->next = descriptor_root->large_object_pool;
+    descriptor_root->large_object_pool = mapping;
+    descriptor_root->number_of_pooled_large_objects++;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_pooled_mem(mapping->mapping_size);
+#endif
+}
+
+object_header_t* large_object_resize(object_header_t *object, size_t size) {
+
+    large_object_t *mapping = LARGE_OBJECT(object);
+    size_t mapping_size = get_mapping_size(size);
+
+    if (mapping_size == 0) {
+        return NULL;
+    }
+
+    if (mapping_size != mapping->mapping_size) {
+        mapping = remap(mapping, mapping_size);
+
+        if (mapping == NULL) {
+            return NULL;
+        }
+    }
+
+    return LARGE_OBJECT_HEADER(mapping);
+}
+
+size_t large_object_usable_size(object_header_t *object) {
+    return LARGE_OBJECT(object)->mapping_size - get_page_size();
+}
+
+#endif  /* SCM_LARGE_OBJECT_ALLOCATION */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _LARGE_OBJECT_H_
+#define	_LARGE_OBJECT_H_
+
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+
+#include "object.h"
+#include "libscm.h"
+
+/*
+ * Large objects are mapped individually. The payload starts at a page
+ * boundary and is preceded by one prefix page that holds the mapping
+ * information at its beginning and the object header at its end.
+ *
+ * -------------------------  <- pointer to large_object_t (page-aligned)
+ * | mapping size          |
+ * | next pooled mapping   |
+ * ~                       ~
+ * | object header         |
+ * -------------------------  <- pointer to the payload (page-aligned)
+ * | payload data          |
+ * ~                       ~
+ * -------------------------
+ */
+typedef struct large_object large_object_t;
+
+// the minimal alignment of the payload of large objects
+#define LARGE_OBJECT_ALIGNMENT 4096
+
+struct large_object {
+    size_t mapping_size;
+
+    // links expired mappings in the large object pool
+    large_object_t* next;
+};
+
+/*
+ * large_object_malloc() maps a new large object or reuses a pooled one.
+ * Returns NULL if no memory could be mapped.
+ */
+object_header_t* large_object_malloc(size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * large_object_free() pools the mapping of a large object after handing
+ * its payload pages back to the OS with MADV_FREE, or unmaps it if the
+ * pool is full.
+ */
+void large_object_free(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/*
+ * large_object_resize() remaps a large object to the new size.
+ * Returns NULL if the mapping could not be resized.
+ */
+object_header_t* large_object_resize(object_header_t *object, size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * large_object_usable_size() returns the payload size of a large object.
+ */
+size_t large_object_usable_size(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+#endif  /* SCM_LARGE_OBJECT_ALLOCATION */
+
+#endif	/* _LARGE_OBJECT_H_ */
@@ -42,12 +42,167 @@
  * the SCM_DESCRIPTOR_PAGE_SIZE results in SCM_DESCRIPTORS_PER_PAGE equal to
  *   ((SCM_DESCRIPTOR_PAGE_SIZE - 2 * sizeof(void*))/sizeof(void*))
  *
+ * coalesce refreshes of an object with a thread-local clock that do not
+ * extend the expiration of a descriptor inserted by a recent refresh.
+ * Recent refreshes are kept in a direct-mapped per-thread cache of
+ * SCM_REFRESH_CACHE_SIZE entries, which must be a power of two.
+ * #define SCM_REFRESH_COALESCING
+ * #define SCM_REFRESH_CACHE_SIZE 64
+ *
+ * count the descriptors of an object that are inserted by the thread that
+ * allocated it without atomic operations. Descriptors of other threads are
+ * counted atomically in a separate counter. At most SCM_MAX_BIASED_OWNERS
+ * threads own objects, objects of other threads are always counted
+ * atomically. Object headers grow by 16 bytes, 8 of which link objects
+ * into the merge queue of their owner.
+ * #define SCM_BIASED_COUNTING
+ * #define SCM_MAX_BIASED_OWNERS 1024
+ *
+ * count the descriptors of objects allocated with scm_malloc_sharded() in
+ * SCM_COUNTER_SHARDS cache-line sized counters, one per thread modulo
+ * SCM_COUNTER_SHARDS, so that threads refreshing the same object do not
+ * contend on its header.
+ * #define SCM_SHARDED_COUNTERS
+ * #define SCM_COUNTER_SHARDS 16
+ *
+ * collect expired descriptors at refreshes and ticks in steps that grow
+ * with the number of objects the thread allocated since the last step,
+ * and at ticks also with the backlog of expired descriptors, which is
+ * drained over SCM_PACER_DRAIN_TICKS ticks. Steps collect at most
+ * SCM_PACER_MAX_STEP descriptors. SCM_EAGER_COLLECTION takes precedence.
+ * With SCM_RECORD_MEMORY_USAGE, the last step and the remaining backlog
+ * are printed with the memory consumption.
+ * #define SCM_COLLECTION_PACER
+ * #define SCM_PACER_DRAIN_TICKS 8
+ * #define SCM_PACER_MAX_STEP 1024
+ *
+ * expire object descriptors on a background reclaimer thread. At ticks,
+ * expired object descriptors are handed over to the reclaimer, which runs
+ * finalizers and frees objects. scm_collect() blocks until the reclaimer
+ * processed the descriptors the calling thread handed over.
+ * scm_collect_n() and scm_collect_for_ns() neither wait for the reclaimer
+ * nor count the descriptors handed over to it. Region descriptors are
+ * still expired by their thread. Cannot be combined with
+ * SCM_BIASED_COUNTING.
+ * #define SCM_BACKGROUND_RECLAIMER
+ *
+ * keep descriptors that expire beyond the ring of their descriptor buffer
+ * in a hierarchical timing wheel of SCM_TIMING_WHEEL_LEVELS levels with
+ * SCM_TIMING_WHEEL_SLOTS slots each, instead of growing the ring. Slots
+ * of level k span SCM_TIMING_WHEEL_SLOTS^(k+1) ticks and keep a page list
+ * per SCM_TIMING_WHEEL_SLOTS^k ticks, so descriptors are inserted in
+ * constant time and share pages with descriptors of the same tick. The
+ * wheel of a descriptor buffer takes SCM_TIMING_WHEEL_LEVELS *
+ * SCM_TIMING_WHEEL_SLOTS^2 * 16 bytes. Descriptor pages keep their
+ * expiration tick, which costs one descriptor per page, so descriptors
+ * in the wheel expire at the same tick as in the ring.
+ * #define SCM_TIMING_WHEEL
+ * #define SCM_TIMING_WHEEL_SLOTS 64
+ * #define SCM_TIMING_WHEEL_LEVELS 2
+ *
+ * store descriptors as 32-bit offsets relative to an 8GB window per
+ * descriptor page, which roughly doubles the number of descriptors per
+ * page for objects that come from the same arena or heap. Descriptors
+ * outside the window of their page take two slots.
+ * #define SCM_COMPRESSED_DESCRIPTORS
+ *
  * an upper bound on the number of descriptor pages that are cached
  * #define SCM_DESCRIPTOR_PAGE_FREELIST_SIZE 10
  *
- * the maximal expiration extension allowed on the scm_refresh calls
+ * the default maximal expiration extension allowed on the scm_refresh
+ * calls, see scm_set_max_expiration_extension()
  * #define SCM_MAX_EXPIRATION_EXTENSION 5
  *
+ * the alignment of the payload of objects, which is either 8 or 16.
+ * An alignment of 16 satisfies max_align_t and SSE loads but pads objects
+ * allocated with malloc by another 8 bytes.
+ * #define SCM_OBJECT_ALIGNMENT 8
+ *
+ * the alignment of the payload of region objects, which must be a power of
+ * two, e.g. 64 to align region objects to cache lines. Defaults to
+ * SCM_OBJECT_ALIGNMENT.
+ * #define SCM_REGION_OBJECT_ALIGNMENT 64
+ *
+ * the pages of a region grow geometrically: the k-th page of a region is
+ * SCM_REGION_PAGE_SIZE << min(k, SCM_REGION_PAGE_MAX_ORDER) bytes large.
+ * Up to SCM_REGION_PAGE_FREELIST_SIZE pages are cached per page size.
+ * 0 keeps all region pages at SCM_REGION_PAGE_SIZE bytes.
+ * #define SCM_REGION_PAGE_MAX_ORDER 4
+ *
+ * objects that do not fit into a region page are allocated in oversized
+ * pages of their own, which expire with the region. Up to
+ * SCM_OVERSIZED_PAGE_FREELIST_SIZE oversized pages of at most
+ * SCM_MAX_POOLED_OVERSIZED_PAGE_SIZE bytes are cached per thread.
+ * #define SCM_OVERSIZED_PAGE_FREELIST_SIZE 4
+ * #define SCM_MAX_POOLED_OVERSIZED_PAGE_SIZE 262144
+ *
+ * carve descriptor pages and region pages from chunks of
+ * SCM_PAGE_CHUNK_SIZE bytes that are mapped per thread instead of
+ * allocating each page with malloc. A chunk is unmapped once all its pages
+ * are freed. SCM_PAGE_CHUNK_HUGE_PAGES advises the kernel to back chunks
+ * with transparent huge pages. SCM_REGION_PAGE_CHUNKS cannot be combined
+ * with SCM_HEADERLESS_REGIONS, whose region pages come from an arena.
+ * #define SCM_DESCRIPTOR_PAGE_CHUNKS
+ * #define SCM_REGION_PAGE_CHUNKS
+ * #define SCM_PAGE_CHUNK_HUGE_PAGES
+ * #define SCM_PAGE_CHUNK_SIZE (2UL << 20)
+ *
+ * size the descriptor and region page pools from the demand for pages per
+ * tick instead of SCM_DESCRIPTOR_PAGE_FREELIST_SIZE and
+ * SCM_REGION_PAGE_FREELIST_SIZE, which become the low watermarks of the
+ * pools. The high watermark follows the peak demand per tick, decays by
+ * 1/2^SCM_PAGE_POOL_DECAY per tick, and is bounded by SCM_MAX_POOLED_PAGES.
+ * Pools are trimmed to their limits at scm_tick_clock().
+ * #define SCM_ADAPTIVE_PAGE_POOLS
+ * #define SCM_PAGE_POOL_DECAY 3
+ * #define SCM_MAX_POOLED_PAGES 1024
+ *
+ * share descriptor pages and region pages between threads. A thread whose
+ * page pool is full hands off the whole pool as a magazine to a global
+ * lock-free depot of SCM_PAGE_DEPOT_SIZE magazines, a thread whose pool is
+ * empty takes a magazine from the depot before allocating new pages.
+ * #define SCM_PAGE_DEPOT
+ * #define SCM_PAGE_DEPOT_SIZE 16
+ *
+ * allocate small objects from thread-local size-class slabs instead of
+ * malloc. Expired small objects are returned to the slabs of the thread
+ * that collects them.
+ * #define SCM_SLAB_ALLOCATION
+ *
+ * the size of a slab and the size of the largest slab block including the
+ * object header. SCM_SLAB_MAX_OBJECT_SIZE should be a multiple of 16.
+ * #define SCM_SLAB_SIZE 16384
+ * #define SCM_SLAB_MAX_OBJECT_SIZE 512
+ *
+ * allocate objects of up to SCM_HEADERLESS_MAX_OBJECT_SIZE bytes without
+ * object header from thread-local spans. Spans are SCM_SPAN_SIZE-aligned
+ * and keep a 4-byte descriptor counter and a 2-byte finalizer index per
+ * block in side arrays, which are found by masking the address of an
+ * object. Spans are carved from an
+ * arena of SCM_HEADERLESS_ARENA_SIZE bytes of reserved address space.
+ * Blocks are multiples of SCM_OBJECT_ALIGNMENT bytes.
+ * #define SCM_HEADERLESS_OBJECTS
+ * #define SCM_HEADERLESS_MAX_OBJECT_SIZE 64
+ * #define SCM_SPAN_SIZE 65536
+ * #define SCM_HEADERLESS_ARENA_SIZE (1UL << 30)
+ *
+ * allocate region objects without object header. Region pages are
+ * SCM_REGION_PAGE_SIZE-aligned units of an arena of SCM_REGION_ARENA_SIZE
+ * bytes of reserved address space and start with an object header that
+ * holds the region id. scm_refresh() finds the region of an object by
+ * masking its address. SCM_REGION_PAGE_SIZE must be a power of two.
+ * Only the most recent allocation of a region can be resized with realloc.
+ * #define SCM_HEADERLESS_REGIONS
+ * #define SCM_REGION_ARENA_SIZE (1UL << 30)
+ *
+ * map objects of at least SCM_LARGE_OBJECT_THRESHOLD bytes individually.
+ * The payload of large objects is page-aligned. The mappings of up to
+ * SCM_LARGE_OBJECT_FREELIST_SIZE expired large objects are cached per thread
+ * after their pages were handed back to the OS with MADV_FREE.
+ * #define SCM_LARGE_OBJECT_ALLOCATION
+ * #define SCM_LARGE_OBJECT_THRESHOLD 262144
+ * #define SCM_LARGE_OBJECT_FREELIST_SIZE 4
+ *
  */
 
 /*
@@ -73,6 +228,62 @@
 #define SCM_REGION_PAGE_FREELIST_SIZE 10
 #endif
 
+#ifndef SCM_REFRESH_CACHE_SIZE
+#define SCM_REFRESH_CACHE_SIZE 64
+#endif
+
+#ifndef SCM_MAX_BIASED_OWNERS
+#define SCM_MAX_BIASED_OWNERS 1024
+#endif
+
+#ifndef SCM_PACER_DRAIN_TICKS
+#define SCM_PACER_DRAIN_TICKS 8
+#endif
+
+#ifndef SCM_PACER_MAX_STEP
+#define SCM_PACER_MAX_STEP 1024
+#endif
+
+#ifndef SCM_TIMING_WHEEL_SLOTS
+#define SCM_TIMING_WHEEL_SLOTS 64
+#endif
+
+#ifndef SCM_TIMING_WHEEL_LEVELS
+#define SCM_TIMING_WHEEL_LEVELS 2
+#endif
+
+#ifndef SCM_COUNTER_SHARDS
+#define SCM_COUNTER_SHARDS 16
+#endif
+
+#ifndef SCM_PAGE_CHUNK_SIZE
+#define SCM_PAGE_CHUNK_SIZE (2UL << 20)
+#endif
+
+#ifndef SCM_PAGE_POOL_DECAY
+#define SCM_PAGE_POOL_DECAY 3
+#endif
+
+#ifndef SCM_MAX_POOLED_PAGES
+#define SCM_MAX_POOLED_PAGES 1024
+#endif
+
+#ifndef SCM_PAGE_DEPOT_SIZE
+#define SCM_PAGE_DEPOT_SIZE 16
+#endif
+
+#ifndef SCM_REGION_PAGE_MAX_ORDER
+#define SCM_REGION_PAGE_MAX_ORDER 0
+#endif
+
+#ifndef SCM_OVERSIZED_PAGE_FREELIST_SIZE
+#define SCM_OVERSIZED_PAGE_FREELIST_SIZE 4
+#endif
+
+#ifndef SCM_MAX_POOLED_OVERSIZED_PAGE_SIZE
+#define SCM_MAX_POOLED_OVERSIZED_PAGE_SIZE 262144
+#endif
+
 #ifndef SCM_MAX_REGIONS
 #define SCM_MAX_REGIONS 10
 #endif
@@ -81,6 +292,46 @@
 #define SCM_MAX_CLOCKS 10
 #endif
 
+#ifndef SCM_OBJECT_ALIGNMENT
+#define SCM_OBJECT_ALIGNMENT 8
+#endif
+
+#ifndef SCM_REGION_OBJECT_ALIGNMENT
+#define SCM_REGION_OBJECT_ALIGNMENT SCM_OBJECT_ALIGNMENT
+#endif
+
+#ifndef SCM_SLAB_SIZE
+#define SCM_SLAB_SIZE 16384
+#endif
+
+#ifndef SCM_SLAB_MAX_OBJECT_SIZE
+#define SCM_SLAB_MAX_OBJECT_SIZE 512
+#endif
+
+#ifndef SCM_HEADERLESS_MAX_OBJECT_SIZE
+#define SCM_HEADERLESS_MAX_OBJECT_SIZE 64
+#endif
+
+#ifndef SCM_SPAN_SIZE
+#define SCM_SPAN_SIZE 65536
+#endif
+
+#ifndef SCM_HEADERLESS_ARENA_SIZE
+#define SCM_HEADERLESS_ARENA_SIZE (1UL << 30)
+#endif
+
+#ifndef SCM_REGION_ARENA_SIZE
+#define SCM_REGION_ARENA_SIZE (1UL << 30)
+#endif
+
+#ifndef SCM_LARGE_OBJECT_THRESHOLD
+#define SCM_LARGE_OBJECT_THRESHOLD 262144
+#endif
+
+#ifndef SCM_LARGE_OBJECT_FREELIST_SIZE
+#define SCM_LARGE_OBJECT_FREELIST_SIZE 4
+#endif
+
 /**
  * scm_block_thread() signals the short-term memory system that
  * the calling thread is about to leave the system for a while e.g. because of
@@ -105,7 +356,7 @@ int scm_register_finalizer(int(*scm_finalizer)(void*));
  * scm_set_finalizer binds a finalizer function id
  * (returned by scm_register_finalizer) to an object (ptr).
  * This function will be executed just before an expired object is
- * deallocated.
+ * deallocated. Objects allocated in a region have no finalizers.
  */
 void scm_set_finalizer(void *ptr, int scm_finalizer_id);
 
@@ -119,6 +370,24 @@ void scm_set_finalizer(void *ptr, int scm_finalizer_id);
  */
 const int scm_register_clock();
 
+/**
+ * scm_register_clock_with_extension() registers a new clock like
+ * scm_register_clock() but sizes the descriptor buffers of the clock for
+ * the given expiration extension, which saves memory for clocks that are
+ * refreshed with short extensions. Buffers still grow when longer
+ * extensions are used.
+ */
+const int scm_register_clock_with_extension(unsigned int extension);
+
+/**
+ * scm_set_max_expiration_extension() sets the maximal expiration extension
+ * allowed on the scm_refresh calls, which defaults to
+ * SCM_MAX_EXPIRATION_EXTENSION. Longer extensions are cut to the maximum.
+ * Descriptor buffers of existing clocks grow when longer extensions are
+ * used, so the maximum may be raised at any time.
+ */
+void scm_set_max_expiration_extension(unsigned int extension);
+
 /**
  * scm_unregister_clock() sets the descriptor buffer age back to a 
  * value that is not equal to the descriptor_root current_time. 
@@ -132,10 +401,19 @@ void scm_unregister_clock(const int clock);
  * if available and -1 otherwise. The new region is detected by scanning
  * the descriptor_root regions array for a region that does not yet have 
  * any region_page, using a next-fit strategy. If such a region is found,
- * a region_page is created and initialized.
+ * a region_page is created and initialized. The pages of the region grow
+ * geometrically up to SCM_REGION_PAGE_SIZE << SCM_REGION_PAGE_MAX_ORDER bytes.
  */
 const int scm_create_region();
 
+/**
+ * scm_create_region_with_page_size() works like scm_create_region() but
+ * all pages of the new region have the smallest supported page size of at
+ * least page_size bytes, i.e. SCM_REGION_PAGE_SIZE << k for some
+ * k <= SCM_REGION_PAGE_MAX_ORDER.
+ */
+const int scm_create_region_with_page_size(size_t page_size);
+
 /**
  * scm_unregister_region() sets the region age back to a value that is not equal
  * to the descriptor_root current_time. As a consequence the region may
@@ -150,15 +428,82 @@ void scm_unregister_region(const int region);
  */
 void *scm_malloc(size_t size);
 
+/**
+ * scm_malloc_refreshed() allocates a short-term memory object and
+ * refreshes it with extension and a given clock, like scm_malloc()
+ * followed by scm_refresh_with_clock(), but without the atomic increment
+ * of the descriptor counter. Returns NULL if the clock is invalid.
+ */
+void *scm_malloc_refreshed(size_t size, unsigned int extension, const unsigned int clock);
+
+/**
+ * scm_malloc_sharded() allocates short-term memory objects for objects
+ * that many threads refresh, e.g. with scm_global_refresh(). With
+ * SCM_SHARDED_COUNTERS each thread counts its descriptors of the object in
+ * its own cache line. Reallocated sharded objects are not sharded anymore.
+ */
+void *scm_malloc_sharded(size_t size);
+
+/**
+ * scm_malloc_aligned() allocates short-term memory objects whose payload
+ * is aligned to alignment bytes, which must be a power of two. Unmodified
+ * code which uses posix_memalign, aligned_alloc, or memalign can be used
+ * with the corresponding --wrap linker options.
+ */
+void *scm_malloc_aligned(size_t size, size_t alignment);
+
 /**
  * scm_malloc_in_region() allocates memory in a region.
+ * The payload is aligned to SCM_REGION_OBJECT_ALIGNMENT. Objects larger
+ * than a region page are allocated in oversized pages of the region.
  * scm_malloc_in_region() wraps an object header around
  * objects allocated in a region. The object header allows to
  * "redirect" a refresh call to a region, if a region object
  * is refreshed.
+ * Region objects may be resized with realloc. The most recent allocation
+ * of a region is resized in place, other objects are copied into the
+ * same region and keep their alignment up to their new size rounded up
+ * to a power of two. Memory that realloc adds to an object is zeroed like
+ * newly allocated memory. Region objects record their size in the object
+ * header in place of the finalizer index, which costs no memory. Objects
+ * without object header (SCM_HEADERLESS_REGIONS) do not record their size,
+ * realloc returns NULL for them unless they are the most recent
+ * allocation of their region.
+ * The memory of a region is zeroed unless zeroing was turned off with
+ * scm_set_region_zeroing(). Region pages are zeroed lazily, only memory
+ * that was used before is cleared when it is allocated again.
  */
 void* scm_malloc_in_region(size_t size, const int region_index);
 
+/**
+ * scm_malloc_in_region_refreshed() allocates memory in a region and
+ * refreshes the region with extension and a given clock, like
+ * scm_malloc_in_region() followed by scm_refresh_region_with_clock().
+ * Returns NULL if the clock is invalid.
+ */
+void* scm_malloc_in_region_refreshed(size_t size, const int region_index, unsigned int extension, const unsigned int clock);
+
+/**
+ * scm_malloc_in_region_aligned() allocates memory in a region whose payload
+ * is aligned to alignment bytes, which must be a power of two. Memory in
+ * front of the object header is skipped to align the payload.
+ */
+void* scm_malloc_in_region_aligned(size_t size, size_t alignment, const int region_index);
+
+/**
+ * scm_calloc_in_region() allocates zeroed memory for nelem elements of
+ * elsize bytes in a region, also if zeroing is turned off for the region.
+ * Memory that is known to be zero is not cleared again.
+ */
+void* scm_calloc_in_region(size_t nelem, size_t elsize, const int region_index);
+
+/**
+ * scm_set_region_zeroing() turns zeroing of the memory allocated in a
+ * region off (zero_memory == 0) or on. Zeroing is turned on whenever a
+ * region is created.
+ */
+void scm_set_region_zeroing(const int region_index, const int zero_memory);
+
 /**
  * scm_free() frees short-term memory objects with no descriptors on
  * them e.g. permanent objects. This function can be used at compile time.
@@ -174,6 +519,27 @@ void scm_free(void *ptr);
  */
 void scm_collect(void);
 
+/*
+ * scm_collect_n processes expired descriptors of the calling thread, like
+ * scm_collect but with a bounded pause, until descriptors of count slots
+ * are collected. It returns the number of slots of expired descriptors
+ * that are left to collect. Both count and the result are in descriptor
+ * slots: a slot is one descriptor, except with SCM_COMPRESSED_DESCRIPTORS,
+ * where descriptors outside the window of their page take two slots.
+ * With SCM_BACKGROUND_RECLAIMER, object descriptors handed over to the
+ * reclaimer are neither collected nor counted.
+ */
+size_t scm_collect_n(size_t count);
+
+/*
+ * scm_collect_for_ns processes expired descriptors of the calling thread
+ * until no expired descriptors are left or budget_ns nanoseconds passed.
+ * The clock is checked every few descriptors, so the budget may be
+ * exceeded slightly. Like scm_collect_n, it returns the number of
+ * descriptor slots of expired descriptors that are left to collect.
+ */
+size_t scm_collect_for_ns(unsigned long long budget_ns);
+
 /**
  * scm_refresh_with_clock() refreshes a given object with a given clock,
  * which can be different to the thread-local base clock.
@@ -183,6 +549,15 @@ void scm_collect(void);
  */
 void scm_refresh_with_clock(void *ptr, unsigned int extension, const unsigned int clock);
 
+/**
+ * scm_refresh_many() refreshes n objects with a given clock as if
+ * scm_refresh_with_clock() was called for each of them, but checks the
+ * extension and the clock only once, inserts descriptors in batches,
+ * and collects expired descriptors only once. NULL pointers are skipped,
+ * objects allocated in regions refresh their region.
+ */
+void scm_refresh_many(void **ptrs, size_t n, unsigned int extension, const unsigned int clock);
+
 /**
  * scm_refresh() adds extension time units to the expiration time of
  * ptr without taking care of other threads.
@@ -216,6 +591,13 @@ void scm_refresh_region_with_clock(const int region_id, unsigned int extension,
  */
 void scm_refresh_region(const int region_id, unsigned int extension);
 
+/**
+ * scm_refresh_region_many() refreshes n regions with a given clock as if
+ * scm_refresh_region_with_clock() was called for each of them, but
+ * collects expired descriptors only once. Invalid region ids are skipped.
+ */
+void scm_refresh_region_many(const int *region_ids, size_t n, unsigned int extension, const unsigned int clock);
+
 /**
  * scm_global_refresh_region() adds extension time units to the expiration time of
  * a region and takes care that all other threads have enough time to also call
@@ -63,6 +63,19 @@ void dec_overhead(long inc) {
     __sync_sub_and_fetch(&mem_overhead, inc);
 }
 
+#ifdef SCM_COLLECTION_PACER
+static long pacer_step = 0;
+static long pacer_backlog = 0;
+
+/**
+ * Keeps track of the last collection step of the pacer
+ */
+void record_pacer_step(long step, long backlog) {
+    pacer_step = step;
+    pacer_backlog = backlog;
+}
+#endif
+
 static long start_time = 0;
 
 /**
@@ -85,6 +98,10 @@ void print_memory_consumption() {
 
     printf("memory overhead:\t%lu\t%lu\n", usec - start_time, mem_overhead);
 
+#ifdef SCM_COLLECTION_PACER
+    printf("collection pacer:\t%lu\t%ld\t%ld\n", usec - start_time, pacer_step, pacer_backlog);
+#endif
+
     // printf("mallinfo:\t%lu\t%d\n", usec - start_time, info.uordblks);
 }
 
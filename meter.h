@@ -37,6 +37,13 @@ void dec_pooled_mem(long inc) __attribute__((visibility("hidden")));
 void inc_overhead(long inc) __attribute__((visibility("hidden")));
 void dec_overhead(long inc) __attribute__((visibility("hidden")));
 
+#ifdef SCM_COLLECTION_PACER
+/**
+ * Keeps track of the last collection step of the pacer
+ */
+void record_pacer_step(long step, long backlog) __attribute__((visibility("hidden")));
+#endif
+
 /**
  * Prints memory consumption
  */
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#include "descriptors.h"
+
+/**
+ * Returns the chunk of an object allocated with __real_memalign.
+ */
+static inline void* get_aligned_chunk(object_header_t *object) {
+    return (void*) object + sizeof(object_header_t)
+        - ((size_t) 1 << object->allocator_info);
+}
+
+void free_object(object_header_t *object) {
+
+    switch (get_object_allocator(object)) {
+#ifdef SCM_SLAB_ALLOCATION
+        case OBJECT_ALLOCATOR_SLAB:
+            slab_free(object);
+            break;
+#endif
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+        case OBJECT_ALLOCATOR_LARGE:
+            large_object_free(object);
+            break;
+#endif
+#ifdef SCM_HEADERLESS_OBJECTS
+        case OBJECT_ALLOCATOR_HEADERLESS:
+            span_free(object);
+            break;
+#endif
+#ifdef SCM_SHARDED_COUNTERS
+        case OBJECT_ALLOCATOR_SHARDED:
+            sharded_free(object);
+            break;
+#endif
+        case OBJECT_ALLOCATOR_ALIGNED:
+#ifdef SCM_RECORD_MEMORY_USAGE
+            dec_overhead((size_t) 1 << object->allocator_info);
+            inc_freed_mem(__real_malloc_usable_size(get_aligned_chunk(object)));
+#endif
+            __real_free(get_aligned_chunk(object));
+            break;
+        default:
+#ifdef SCM_RECORD_MEMORY_USAGE
+            dec_overhead(OBJECT_PREFIX_SIZE);
+            inc_freed_mem(__real_malloc_usable_size(MALLOC_CHUNK(object)));
+#endif
+            __real_free(MALLOC_CHUNK(object));
+    }
+}
+
+object_header_t* resize_object(object_header_t *object, size_t size) {
+
+    switch (get_object_allocator(object)) {
+#ifdef SCM_SLAB_ALLOCATION
+        case OBJECT_ALLOCATOR_SLAB:
+            //slab blocks are resized in place as long as they fit the block
+            if (size <= slab_usable_size(object)) {
+                return object;
+            }
+            return NULL;
+#endif
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+        case OBJECT_ALLOCATOR_LARGE:
+            return large_object_resize(object, size);
+#endif
+#ifdef SCM_HEADERLESS_OBJECTS
+        case OBJECT_ALLOCATOR_HEADERLESS:
+            if (size <= span_usable_size(object)) {
+                return object;
+            }
+            return NULL;
+#endif
+        case OBJECT_ALLOCATOR_ALIGNED:
+            //realloc does not preserve the alignment
+            return NULL;
+#ifdef SCM_SHARDED_COUNTERS
+        case OBJECT_ALLOCATOR_SHARDED:
+            //the copy is not sharded
+            return NULL;
+#endif
+        default: {
+#ifdef SCM_RECORD_MEMORY_USAGE
+            size_t old_size = __real_malloc_usable_size(MALLOC_CHUNK(object));
+#endif
+            //grows in place if possible, large chunks are remapped
+            void *new_chunk =
+                __real_realloc(MALLOC_CHUNK(object), size + OBJECT_PREFIX_SIZE);
+
+            if (new_chunk == NULL) {
+                return NULL;
+            }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+            inc_freed_mem(old_size);
+            inc_allocated_mem(__real_malloc_usable_size(new_chunk));
+#endif
+            return MALLOC_OBJECT(new_chunk);
+        }
+    }
+}
+
+size_t object_usable_size(object_header_t *object) {
+
+    switch (get_object_allocator(object)) {
+#ifdef SCM_SLAB_ALLOCATION
+        case OBJECT_ALLOCATOR_SLAB:
+            return slab_usable_size(object);
+#endif
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+        case OBJECT_ALLOCATOR_LARGE:
+            return large_object_usable_size(object);
+#endif
+#ifdef SCM_HEADERLESS_OBJECTS
+        case OBJECT_ALLOCATOR_HEADERLESS:
+            return span_usable_size(object);
+#endif
+#ifdef SCM_SHARDED_COUNTERS
+        case OBJECT_ALLOCATOR_SHARDED:
+            return sharded_usable_size(object);
+#endif
+        case OBJECT_ALLOCATOR_ALIGNED:
+            return __real_malloc_usable_size(get_aligned_chunk(object))
+                - ((size_t) 1 << object->allocator_info);
+        default:
+            return __real_malloc_usable_size(MALLOC_CHUNK(object))
+                - OBJECT_PREFIX_SIZE;
+    }
+}
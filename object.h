@@ -9,12 +9,16 @@
 #define	_OBJECT_H_
 
 #include <string.h>
+#include <limits.h>
+
+#include "libscm.h"
 
 extern void* __real_malloc(size_t size);
 extern void* __real_calloc(size_t nelem, size_t elsize);
 extern void* __real_realloc(void *ptr, size_t size);
 extern void __real_free(void *ptr);
 extern size_t __real_malloc_usable_size(void *ptr);
+extern void* __real_memalign(size_t alignment, size_t size);
 
 /*
  * objects allocated through libscm have an additional object header that
@@ -23,7 +27,8 @@ extern size_t __real_malloc_usable_size(void *ptr);
  * -------------------------  <- pointer to object_header_t
  * | descriptor counter OR |
  * | region id AND         |
- * | finalizer index       |
+ * | finalizer index AND   |
+ * | allocator             |
  * -------------------------  <- pointer to the payload data that is
  * | payload data          |     returned to the user
  * ~ returned to user      ~
@@ -39,14 +44,195 @@ struct object_header {
     // A negative value indicates region allocation. Resetting the
     // hsb returns the region id.
     int dc_or_region_id;
-    // finalizer_index must be signed so that a finalizer_index
-    // may be set to -1 indicating that no finalizer exists
-    int finalizer_index;
+    union {
+        struct {
+            // finalizer_index must be signed so that a finalizer_index
+            // may be set to -1 indicating that no finalizer exists
+            short finalizer_index;
+            // allocator identifies the allocator that provided the memory
+            // of the object (see OBJECT_ALLOCATOR_*). allocator_info holds
+            // allocator specific information, e.g. the size class of slab
+            // objects.
+            unsigned char allocator;
+            unsigned char allocator_info;
+        };
+        // objects allocated in region pages have neither a finalizer nor
+        // an allocator of their own but record their size instead
+        unsigned int region_object_size;
+    };
+#ifdef SCM_BIASED_COUNTING
+    // the descriptors inserted by the owner of the object, which are
+    // counted without atomic operations until the owner merged the
+    // counter into dc_or_region_id (see DC_MERGED)
+    unsigned int biased_dc;
+    // the owner id of the descriptor root of the thread that allocated
+    // the object, or 0 if the object is always counted atomically
+    unsigned int owner;
+    // the next object in the merge queue of the owner while DC_QUEUED
+    // is set in dc_or_region_id
+    object_header_t *merge_next;
+#endif
 };
 
+// the hsb of dc_or_region_id that marks region objects
+#define HB_MASK (UINT_MAX - INT_MAX)
+
+#ifdef SCM_BIASED_COUNTING
+// the owner does not count descriptors in biased_dc anymore
+#define DC_MERGED (1 << 30)
+// the object waits in the merge queue of its owner
+#define DC_QUEUED (1 << 29)
+// the descriptors counted atomically in dc_or_region_id
+#define DC_COUNT_MASK (DC_QUEUED - 1)
+#endif
+
+// the object was allocated with __real_malloc
+#define OBJECT_ALLOCATOR_MALLOC 0
+// the object was allocated from a thread-local slab
+#define OBJECT_ALLOCATOR_SLAB 1
+// the object was mapped individually
+#define OBJECT_ALLOCATOR_LARGE 2
+// the object was allocated with __real_memalign. The payload starts
+// 2^allocator_info bytes after the chunk, the smallest power of two
+// multiple of its alignment that holds the object header.
+#define OBJECT_ALLOCATOR_ALIGNED 3
+// the object was allocated from a span without header. Its descriptor
+// counter and finalizer index are kept in the side arrays of the span.
+#define OBJECT_ALLOCATOR_HEADERLESS 4
+// the object counts its descriptors in shards in front of its header
+#define OBJECT_ALLOCATOR_SHARDED 5
+
+#ifdef SCM_HEADERLESS_OBJECTS
+#include "span.h"
+#endif
+
+#ifdef SCM_HEADERLESS_REGIONS
+#include "arena.h"
+
+// the arena that holds all region pages. The units of the arena are as
+// large as the largest region page.
+extern arena_t region_page_arena __attribute__((visibility("hidden")));
+
+#define REGION_PAGE_UNIT_SIZE \
+    ((unsigned long) SCM_REGION_PAGE_SIZE << SCM_REGION_PAGE_MAX_ORDER)
+
+// region pages start with the object header of all objects of the page
+#define REGION_PAGE_OBJECT_HEADER(_ptr) \
+    ((object_header_t*) ARENA_UNIT_OF(_ptr, REGION_PAGE_UNIT_SIZE))
+#endif
+
+#if defined(SCM_HEADERLESS_OBJECTS) || defined(SCM_HEADERLESS_REGIONS)
+
+/*
+ * get_object_header() returns the object header of payload ptr, which is
+ * located before the payload, in the side array of a span or at the
+ * beginning of a region page.
+ */
+static inline object_header_t* get_object_header(void *ptr) {
+#ifdef SCM_HEADERLESS_OBJECTS
+    if (is_headerless(ptr)) {
+        return span_object_header(ptr);
+    }
+#endif
+#ifdef SCM_HEADERLESS_REGIONS
+    if (arena_contains(&region_page_arena, ptr)) {
+        return REGION_PAGE_OBJECT_HEADER(ptr);
+    }
+#endif
+
+    return (object_header_t*) (ptr - sizeof(object_header_t));
+}
+
+/*
+ * get_object_payload() is the inverse of get_object_header() for objects
+ * that were not allocated in a region.
+ */
+static inline void* get_object_payload(object_header_t *object) {
+#ifdef SCM_HEADERLESS_OBJECTS
+    if (is_headerless(object)) {
+        return span_object_payload(object);
+    }
+#endif
+
+    return (void*) object + sizeof(object_header_t);
+}
+
+#define OBJECT_HEADER(_ptr) get_object_header(_ptr)
+#define PAYLOAD_OFFSET(_o) get_object_payload(_o)
+
+#else
+
 #define OBJECT_HEADER(_ptr) \
     (object_header_t*)(_ptr - sizeof(object_header_t))
 #define PAYLOAD_OFFSET(_o) \
     ((void*)(_o) + sizeof(object_header_t))
 
+#endif  /* SCM_HEADERLESS_OBJECTS || SCM_HEADERLESS_REGIONS */
+
+/*
+ * get_object_allocator() returns the allocator that provided the memory of
+ * an object (see OBJECT_ALLOCATOR_*). The side header of a headerless
+ * object only holds its descriptor counter.
+ */
+static inline unsigned char get_object_allocator(object_header_t *object) {
+#ifdef SCM_HEADERLESS_OBJECTS
+    if (is_headerless(object)) {
+        return OBJECT_ALLOCATOR_HEADERLESS;
+    }
+#endif
+
+    return object->allocator;
+}
+
+/*
+ * get_finalizer_index() returns a pointer to the finalizer index of an
+ * object, which headerless objects keep in the side array of their span.
+ */
+static inline short* get_finalizer_index(object_header_t *object) {
+#ifdef SCM_HEADERLESS_OBJECTS
+    if (is_headerless(object)) {
+        return span_object_finalizer(object);
+    }
+#endif
+
+    return &object->finalizer_index;
+}
+
+#if SCM_OBJECT_ALIGNMENT != 8 && SCM_OBJECT_ALIGNMENT != 16
+#error "SCM_OBJECT_ALIGNMENT must be 8 or 16"
+#endif
+
+// Objects allocated with __real_malloc reserve OBJECT_PREFIX_SIZE bytes
+// in front of the payload for the object header, which keeps the payload
+// of 16-byte aligned chunks aligned to SCM_OBJECT_ALIGNMENT.
+#define OBJECT_PREFIX_SIZE \
+    ((sizeof(object_header_t) + SCM_OBJECT_ALIGNMENT - 1) \
+        & ~(SCM_OBJECT_ALIGNMENT - 1))
+#define MALLOC_CHUNK(_o) \
+    ((void*)(_o) + sizeof(object_header_t) - OBJECT_PREFIX_SIZE)
+#define MALLOC_OBJECT(_chunk) \
+    ((object_header_t*) ((void*)(_chunk) + OBJECT_PREFIX_SIZE \
+        - sizeof(object_header_t)))
+
+/*
+ * free_object() hands the memory of an object back to the allocator
+ * that provided it.
+ */
+void free_object(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/*
+ * resize_object() resizes an object without descriptors in place, if its
+ * allocator supports that, and returns the possibly moved object.
+ * Returns NULL if the object must be copied into a new object instead.
+ */
+object_header_t* resize_object(object_header_t *object, size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * object_usable_size() returns the number of payload bytes of an object.
+ */
+size_t object_usable_size(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
 #endif	/* _OBJECT_H_ */
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#include "reclaimer.h"
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+
+#include <pthread.h>
+#include <semaphore.h>
+
+// the descriptor roots with handed over pages, linked through
+// next_to_reclaim
+static descriptor_root_t* volatile reclaim_queue = NULL;
+
+// posted once per root pushed onto the reclaim queue
+static sem_t reclaim_signal;
+
+static pthread_once_t reclaimer_once_control = PTHREAD_ONCE_INIT;
+
+static volatile bool reclaimer_running = false;
+
+/**
+ * Reclaims the pages the thread of root handed over and wakes up the
+ * thread if it waits for the reclaimer.
+ */
+static void reclaim_root(descriptor_root_t *root) {
+    pthread_mutex_lock(&root->reclaim_lock);
+    root->reclaiming = true;
+    pthread_mutex_unlock(&root->reclaim_lock);
+
+    //pages handed over from now on queue the root again
+    root->queued = 0;
+
+    descriptor_page_t *page = atomic_pointer_exchange(
+        (void* volatile*) &root->handed_over_pages, NULL);
+
+    //the pages are a stack of lists, reclaim in the order of expiration
+    descriptor_page_t *ordered = NULL;
+
+    while (page != NULL) {
+        descriptor_page_t *next = page->next;
+
+        page->next = ordered;
+        ordered = page;
+
+        page = next;
+    }
+
+    if (ordered != NULL) {
+        reclaim_expired_objects(root, ordered);
+    }
+
+    pthread_mutex_lock(&root->reclaim_lock);
+    root->reclaiming = false;
+    pthread_cond_broadcast(&root->reclaimed);
+    pthread_mutex_unlock(&root->reclaim_lock);
+}
+
+static void* reclaimer(void *arg) {
+    while (true) {
+        if (sem_wait(&reclaim_signal) != 0) {
+            //interrupted
+            continue;
+        }
+
+        descriptor_root_t *root = atomic_pointer_exchange(
+            (void* volatile*) &reclaim_queue, NULL);
+
+        while (root != NULL) {
+            descriptor_root_t *next = root->next_to_reclaim;
+
+            reclaim_root(root);
+
+            root = next;
+        }
+    }
+
+    return NULL;
+}
+
+static void start_reclaimer() {
+    pthread_t thread;
+
+    if (sem_init(&reclaim_signal, 0, 0) != 0) {
+#ifdef SCM_DEBUG
+        printf("sem_init failed, descriptors are expired by their thread.\n");
+#endif
+        return;
+    }
+
+    if (pthread_create(&thread, NULL, reclaimer, NULL) != 0) {
+#ifdef SCM_DEBUG
+        printf("pthread_create failed, descriptors are expired by their thread.\n");
+#endif
+        return;
+    }
+
+    pthread_detach(thread);
+
+    reclaimer_running = true;
+}
+
+void init_reclaimer_root(descriptor_root_t *root) {
+    pthread_mutex_init(&root->reclaim_lock, NULL);
+    pthread_cond_init(&root->reclaimed, NULL);
+}
+
+void hand_over_expired_buffer(descriptor_buffer_t *buffer) {
+    pthread_once(&reclaimer_once_control, start_reclaimer);
+
+    unsigned int to_be_expired_index =
+        (buffer->current_index - 1) & (buffer->not_expired_length - 1);
+
+    descriptor_page_list_t *list = &buffer->not_expired[to_be_expired_index];
+
+    if (list->first == NULL || list->first->number_of_descriptors == 0) {
+        //nothing expired
+        return;
+    }
+
+    if (!reclaimer_running) {
+        expire_buffer(buffer, &descriptor_root->list_of_expired_obj_descriptors);
+        return;
+    }
+
+    descriptor_page_t *head;
+
+    do {
+        head = descriptor_root->handed_over_pages;
+        list->last->next = head;
+    } while (atomic_pointer_compare_and_exchange(
+                (void* volatile*) &descriptor_root->handed_over_pages,
+                head, list->first) != head);
+
+    list->first = NULL;
+    list->last = NULL;
+
+    if (atomic_int_compare_and_exchange(&descriptor_root->queued, 0, 1) != 0) {
+        //the root waits in the queue already
+        return;
+    }
+
+    descriptor_root_t *root;
+
+    do {
+        root = reclaim_queue;
+        descriptor_root->next_to_reclaim = root;
+    } while (atomic_pointer_compare_and_exchange(
+                (void* volatile*) &reclaim_queue, root, descriptor_root) != root);
+
+    sem_post(&reclaim_signal);
+}
+
+void wait_for_reclaimer() {
+    pthread_mutex_lock(&descriptor_root->reclaim_lock);
+
+    while (descriptor_root->handed_over_pages != NULL
+            || descriptor_root->reclaiming) {
+        pthread_cond_wait(&descriptor_root->reclaimed,
+                          &descriptor_root->reclaim_lock);
+    }
+
+    pthread_mutex_unlock(&descriptor_root->reclaim_lock);
+
+    recycle_reclaimed_descriptor_pages();
+}
+
+#endif  /* SCM_BACKGROUND_RECLAIMER */
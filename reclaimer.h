@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _RECLAIMER_H_
+#define	_RECLAIMER_H_
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+
+#ifdef SCM_BIASED_COUNTING
+#error "SCM_BACKGROUND_RECLAIMER cannot be combined with SCM_BIASED_COUNTING"
+#endif
+
+#include "descriptors.h"
+
+/*
+ * The reclaimer is a thread that expires object descriptors in the
+ * background. At ticks, threads detach the expired page list of their
+ * locally and globally clocked object buffers and push its pages onto the
+ * lock-free stack of handed over pages of their descriptor root instead of
+ * appending them to their list of expired object descriptors. A root with
+ * handed over pages is queued once in a lock-free queue of roots for the
+ * reclaimer. The reclaimer decrements the descriptor counters, runs the
+ * finalizers, frees the objects, and gives the descriptor pages back to
+ * the thread. Handing over allocates no memory. Region descriptors are still expired by their thread, since
+ * recycling a region changes state of the thread.
+ *
+ * The reclaimer has no descriptor root, so the memory of freed objects is
+ * handed over to the orphaned blocks of the slab and span allocators.
+ */
+
+/* init_reclaimer_root()
+ * initializes the reclaimer state of a new descriptor root */
+void init_reclaimer_root(descriptor_root_t *root)
+    __attribute__((visibility("hidden")));
+
+/* hand_over_expired_buffer()
+ * hands the list of a descriptor buffer at current_index - 1
+ * over to the reclaimer, or expires it if there is no reclaimer */
+void hand_over_expired_buffer(descriptor_buffer_t *buffer)
+    __attribute__((visibility("hidden")));
+
+/* wait_for_reclaimer()
+ * blocks until the reclaimer processed all pages the
+ * calling thread handed over and recycles them */
+void wait_for_reclaimer(void)
+    __attribute__((visibility("hidden")));
+
+#endif  /* SCM_BACKGROUND_RECLAIMER */
+
+#endif	/* _RECLAIMER_H_ */
@@ -10,25 +10,57 @@
 /**
  * Allocates memory, e.g. with ptmalloc2, and
  * wraps object header around requested memory.
+ * Large objects are mapped individually. Small objects are allocated
+ * from the spans or slabs of the calling thread if the thread has a
+ * descriptor root.
  */
 void *__wrap_malloc(size_t size) {
 
-    object_header_t* object =
-        (object_header_t*) (__real_malloc(size + sizeof(object_header_t)));
+    object_header_t* object = NULL;
 
-    if (!object) {
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+    if (size >= SCM_LARGE_OBJECT_THRESHOLD) {
+        object = large_object_malloc(size);
+    }
+#endif
+
+#ifdef SCM_HEADERLESS_OBJECTS
+    if (object == NULL && descriptor_root != NULL) {
+        object = span_malloc(size);
+    }
+#endif
+
+#ifdef SCM_SLAB_ALLOCATION
+    if (object == NULL && descriptor_root != NULL) {
+        object = slab_malloc(size);
+    }
+#endif
+
+    if (object) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+        print_memory_consumption();
+#endif
+        return PAYLOAD_OFFSET(object);
+    }
+
+    void* chunk = __real_malloc(size + OBJECT_PREFIX_SIZE);
+
+    if (!chunk) {
 #ifdef SCM_DEBUG
         printf("malloc failed.\n");
 #endif
         return NULL;
     }
 
-    object->dc_or_region_id = 0;
+    object = MALLOC_OBJECT(chunk);
+
+    init_descriptor_counter(object);
     object->finalizer_index = -1;
+    object->allocator = OBJECT_ALLOCATOR_MALLOC;
 
 #ifdef SCM_RECORD_MEMORY_USAGE
-    inc_overhead(sizeof(object_header_t));
-    inc_allocated_mem(__real_malloc_usable_size(object));
+    inc_overhead(OBJECT_PREFIX_SIZE);
+    inc_allocated_mem(__real_malloc_usable_size(chunk));
 
     print_memory_consumption();
 #endif
@@ -49,34 +81,53 @@ void *__wrap_calloc(size_t nelem, size_t elsize) {
     return p;
 }
 
+static void* realloc_in_region(void *ptr, size_t size, const int region_index);
+
+static void refresh_region(const int region_index, unsigned int extension,
+                           const unsigned int clock);
+
 /**
  * Reallocates memory, e.g. with ptmalloc2, and
  * wraps object header around requested memory.
+ * Objects without descriptors are resized in place if possible,
+ * otherwise the payload is copied into a new object.
  */
 void *__wrap_realloc(void *ptr, size_t size) {
 
     if (ptr == NULL) return __wrap_malloc_internal(size);
+
+    object_header_t* old_object = OBJECT_HEADER(ptr);
+
+    if (old_object->dc_or_region_id < 0) {
+        //region objects are reallocated in their region
+        return realloc_in_region(ptr, size,
+                                 old_object->dc_or_region_id & ~HB_MASK);
+    }
+
+    if (!has_descriptors(old_object)) {
+        //nobody else refers to the old object, so it may move
+        object_header_t* resized_object = resize_object(old_object, size);
+
+        if (resized_object) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+            print_memory_consumption();
+#endif
+            return PAYLOAD_OFFSET(resized_object);
+        }
+    }
+
     //else: create new object
-    object_header_t* new_object =
-        (object_header_t*) __real_malloc(size + sizeof(object_header_t));
+    void *new_ptr = __wrap_malloc_internal(size);
 
-    if (!new_object) {
+    if (!new_ptr) {
 #ifdef SCM_DEBUG
         printf("realloc failed.\n");
 #endif
         return NULL;
     }
-    new_object->dc_or_region_id = 0;
-    new_object->finalizer_index = -1;
-
-#ifdef SCM_RECORD_MEMORY_USAGE
-    inc_overhead(sizeof(object_header_t));
-#endif
 
     //get the minimum of the old size and the new size
-    size_t old_object_size =
-        __real_malloc_usable_size(OBJECT_HEADER(ptr))
-        - sizeof (object_header_t);
+    size_t old_object_size = object_usable_size(old_object);
     size_t lesser_object_size;
 
     if (old_object_size >= size) {
@@ -85,29 +136,15 @@ void *__wrap_realloc(void *ptr, size_t size) {
         lesser_object_size = old_object_size;
     }
 
-    object_header_t* old_object = OBJECT_HEADER(ptr);
     //copy payload bytes 0..(lesser_size-1) from the old object to the new one
-    memcpy(PAYLOAD_OFFSET(new_object),
-           PAYLOAD_OFFSET(old_object),
-           lesser_object_size);
+    memcpy(new_ptr, ptr, lesser_object_size);
 
-    if (old_object->dc_or_region_id == 0) {
+    if (!has_descriptors(old_object)) {
         //if the old object has no descriptors, we can free it
-
-#ifdef SCM_RECORD_MEMORY_USAGE
-        inc_freed_mem(__real_malloc_usable_size(old_object));
-        dec_overhead(sizeof(object_header_t));
-#endif
-
-        __real_free(old_object);
+        free_object(old_object);
     } //else: the old object will be freed later due to expiration
 
-#ifdef SCM_RECORD_MEMORY_USAGE
-    inc_allocated_mem(__real_malloc_usable_size(new_object));
-    print_memory_consumption();
-#endif
-
-    return PAYLOAD_OFFSET(new_object);
+    return new_ptr;
 }
 
 /**
@@ -119,16 +156,11 @@ void __wrap_free(void *ptr) {
 
     object_header_t* object = OBJECT_HEADER(ptr);
 
-    if (object->dc_or_region_id == 0) {
-#ifdef SCM_RECORD_MEMORY_USAGE
-        dec_overhead(sizeof(object_header_t));
-        inc_freed_mem(__real_malloc_usable_size(object));
-#endif
-
-        __real_free(object);
+    if (object->dc_or_region_id >= 0 && !has_descriptors(object)) {
+        free_object(object);
     } else {
 #ifdef SCM_DEBUG
-        if(object->dc_or_region_id > 0) {
+        if(object->dc_or_region_id >= 0) {
             printf("Cannot free objects which are still referenced.\n");
         } else if(object->dc_or_region_id < 0) {
             printf("Cannot free single objects from a region.\n");
@@ -148,7 +180,124 @@ size_t __wrap_malloc_usable_size(void *ptr) {
 
     object_header_t* object = OBJECT_HEADER(ptr);
 
-    return __real_malloc_usable_size(object) - sizeof(object_header_t);
+    return object_usable_size(object);
+}
+
+/**
+ * Allocates memory whose payload is aligned to alignment bytes and
+ * wraps object header around requested memory. The object header is
+ * placed right before the payload. If alignment is not a power of two,
+ * it is rounded up to the next power of two.
+ */
+void *__wrap_memalign(size_t alignment, size_t size) {
+
+    if (!IS_POWER_OF_TWO(alignment)) {
+        size_t power_of_two = sizeof(void*);
+
+        while (power_of_two < alignment && power_of_two <= SIZE_MAX / 2) {
+            power_of_two <<= 1;
+        }
+
+        if (power_of_two < alignment) {
+            errno = EINVAL;
+            return NULL;
+        }
+
+        alignment = power_of_two;
+    }
+
+    if (alignment <= SCM_OBJECT_ALIGNMENT) {
+        return __wrap_malloc_internal(size);
+    }
+
+    object_header_t* object = NULL;
+
+#ifdef SCM_LARGE_OBJECT_ALLOCATION
+    if (size >= SCM_LARGE_OBJECT_THRESHOLD && alignment <= LARGE_OBJECT_ALIGNMENT) {
+        object = large_object_malloc(size);
+    }
+#endif
+
+#ifdef SCM_SLAB_ALLOCATION
+    if (object == NULL && alignment <= SLAB_BLOCK_ALIGNMENT
+            && descriptor_root != NULL) {
+        object = slab_malloc(size);
+    }
+#endif
+
+    if (object) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+        print_memory_consumption();
+#endif
+        return PAYLOAD_OFFSET(object);
+    }
+
+    //the payload is preceded by a power of two multiple of the alignment
+    //that holds the object header
+    size_t prefix = alignment;
+
+    while (prefix < sizeof(object_header_t)) {
+        prefix <<= 1;
+    }
+
+    if (size > SIZE_MAX - prefix) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    void* chunk = __real_memalign(alignment, prefix + size);
+
+    if (!chunk) {
+#ifdef SCM_DEBUG
+        printf("memalign failed.\n");
+#endif
+        return NULL;
+    }
+
+    object = (object_header_t*) (chunk + prefix - sizeof(object_header_t));
+
+    init_descriptor_counter(object);
+    object->finalizer_index = -1;
+    object->allocator = OBJECT_ALLOCATOR_ALIGNED;
+    object->allocator_info = __builtin_ctzl(prefix);
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_overhead(prefix);
+    inc_allocated_mem(__real_malloc_usable_size(chunk));
+
+    print_memory_consumption();
+#endif
+
+    return PAYLOAD_OFFSET(object);
+}
+
+extern __typeof__(__wrap_memalign) __wrap_memalign_internal
+    __attribute__((weak, alias("__wrap_memalign"), visibility("hidden")));
+
+int __wrap_posix_memalign(void **memptr, size_t alignment, size_t size) {
+
+    if (!IS_POWER_OF_TWO(alignment) || alignment % sizeof(void*) != 0) {
+        return EINVAL;
+    }
+
+    void *ptr = __wrap_memalign_internal(alignment, size);
+
+    if (ptr == NULL) {
+        return ENOMEM;
+    }
+
+    *memptr = ptr;
+    return 0;
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size) {
+
+    if (!IS_POWER_OF_TWO(alignment)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return __wrap_memalign_internal(alignment, size);
 }
 
 // The descriptor root is stored as thread-local storage variable.
@@ -182,6 +331,13 @@ static inline void unlock_descriptor_roots() {
     pthread_mutex_unlock(&terminated_descriptor_roots_lock);
 }
 
+// the maximal expiration extension accepted by refreshes
+static unsigned int max_expiration_extension = SCM_MAX_EXPIRATION_EXTENSION;
+
+// an upper bound on max_expiration_extension that keeps ring lengths of
+// the globally clocked buffers in range
+#define MAX_EXPIRATION_EXTENSION_LIMIT (1U << 30)
+
 /**
  * new_descriptor_root() allocates space for the descriptor_root and
  * initializes its data.
@@ -199,18 +355,34 @@ static descriptor_root_t* new_descriptor_root() {
 
     descriptor_root->next_clock_index = 1;
 
-    descriptor_root->globally_clocked_obj_buffer.not_expired_length =
-        SCM_MAX_EXPIRATION_EXTENSION + 2;
-    descriptor_root->globally_clocked_reg_buffer.not_expired_length =
-        SCM_MAX_EXPIRATION_EXTENSION + 2;
-    descriptor_root->locally_clocked_obj_buffer[0].not_expired_length =
-        SCM_MAX_EXPIRATION_EXTENSION + 1;
-    descriptor_root->locally_clocked_reg_buffer[0].not_expired_length =
-        SCM_MAX_EXPIRATION_EXTENSION + 1;
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+    init_page_pools(descriptor_root);
+#endif
+
+    reserve_descriptor_buffer(&descriptor_root->globally_clocked_obj_buffer,
+                              max_expiration_extension + 2);
+    reserve_descriptor_buffer(&descriptor_root->globally_clocked_reg_buffer,
+                              max_expiration_extension + 2);
+    reserve_descriptor_buffer(&descriptor_root->locally_clocked_obj_buffer[0],
+                              max_expiration_extension);
+    reserve_descriptor_buffer(&descriptor_root->locally_clocked_reg_buffer[0],
+                              max_expiration_extension);
 
     descriptor_root->round_robin = 1;
     descriptor_root->blocked = true;
 
+#ifdef SCM_BIASED_COUNTING
+    register_owner(descriptor_root);
+#endif
+
+#ifdef SCM_SHARDED_COUNTERS
+    descriptor_root->counter_shard = next_counter_shard();
+#endif
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+    init_reclaimer_root(descriptor_root);
+#endif
+
     return descriptor_root;
 }
 
@@ -436,14 +608,31 @@ static void create_descriptor_root() {
 }
 
 /**
- * scm_register_clock() returns a const integer representing
+ * scm_set_max_expiration_extension() sets the maximal expiration extension
+ * accepted by refreshes. Descriptor buffers grow when longer extensions
+ * are used.
+ */
+void scm_set_max_expiration_extension(unsigned int extension) {
+    if (extension > MAX_EXPIRATION_EXTENSION_LIMIT) {
+#ifdef SCM_DEBUG
+        printf("Maximal expiration extension is too large.\n");
+#endif
+        extension = MAX_EXPIRATION_EXTENSION_LIMIT;
+    }
+
+    max_expiration_extension = extension;
+}
+
+/**
+ * scm_register_clock_with_extension() returns a const integer representing
  * a new clock in the short-term memory model.
  * A clock identifies a descriptor buffer in the array of locally
- * clocked descriptor buffers of the descriptor root.
+ * clocked descriptor buffers of the descriptor root. The descriptor
+ * buffers of the clock are sized for the given expiration extension.
  * If all available clocks/descriptor buffers are in use, the return value is
  * set to -1, indicating an error for the caller function.
  */
-const int scm_register_clock() {
+const int scm_register_clock_with_extension(unsigned int extension) {
     create_descriptor_root();
 
     if (SCM_MAX_CLOCKS <= 1) {
@@ -471,10 +660,14 @@ const int scm_register_clock() {
     start_index = start_index != 0 ? start_index : 1;
     descriptor_root->next_clock_index = start_index;
 
-    descriptor_root->locally_clocked_obj_buffer[i].not_expired_length =
-        SCM_MAX_EXPIRATION_EXTENSION + 1;
-    descriptor_root->locally_clocked_reg_buffer[i].not_expired_length =
-        SCM_MAX_EXPIRATION_EXTENSION + 1;
+    if (extension > max_expiration_extension) {
+        extension = max_expiration_extension;
+    }
+
+    reserve_descriptor_buffer(&descriptor_root->locally_clocked_obj_buffer[i],
+                              extension);
+    reserve_descriptor_buffer(&descriptor_root->locally_clocked_reg_buffer[i],
+                              extension);
 
     descriptor_root->locally_clocked_obj_buffer[i].age =
         descriptor_root->current_time;
@@ -484,6 +677,14 @@ const int scm_register_clock() {
     return (const int) i;
 }
 
+/**
+ * scm_register_clock() registers a new clock whose descriptor buffers are
+ * sized for the maximal expiration extension.
+ */
+const int scm_register_clock() {
+    return scm_register_clock_with_extension(max_expiration_extension);
+}
+
 /**
  * scm_unregister_clock() sets the age of the descriptor buffer
  * back to a value that is not equal to the descriptor_root current_time. 
@@ -510,7 +711,8 @@ void scm_unregister_clock(const int clock) {
 
 /**
  * init_region_page() creates and initializes a new region page if no other
- * region page exists or if all other region pages are full.
+ * region page exists or if all other region pages are full. The page is
+ * taken from the pool of its size if possible. Its memory is not zeroed.
  * The region_page is allocated page-aligned.
  */
 static region_page_t* init_region_page(region_t* region) {
@@ -528,18 +730,37 @@ static region_page_t* init_region_page(region_t* region) {
 
     region_page_t* prevLastPage = region->lastPage;
 
-    region_page_t* new_page = descriptor_root->region_page_pool;
+    unsigned int order = region->page_order;
+
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+    descriptor_root->region_page_pool_sizing[order].demand++;
+#endif
+
+#ifdef SCM_PAGE_DEPOT
+    if (descriptor_root->region_page_pool[order] == NULL) {
+        refill_region_page_pool(order);
+    }
+#endif
+
+    region_page_t* new_page = descriptor_root->region_page_pool[order];
 
     if (new_page != NULL) {
 
-        descriptor_root->region_page_pool = new_page->nextPage;
-        descriptor_root->number_of_pooled_region_pages--;
+        descriptor_root->region_page_pool[order] = new_page->nextPage;
+        descriptor_root->number_of_pooled_region_pages[order]--;
 #ifdef SCM_RECORD_MEMORY_USAGE
-        dec_pooled_mem(sizeof (region_page_t));
+        dec_pooled_mem(REGION_PAGE_SIZE(order));
 #endif
     }
     else {
-        new_page = __real_malloc(SCM_REGION_PAGE_SIZE);
+#ifdef SCM_HEADERLESS_REGIONS
+        new_page = arena_alloc(&region_page_arena);
+#elif defined(SCM_REGION_PAGE_CHUNKS)
+        new_page = chunk_alloc_page(&descriptor_root->page_chunks,
+                                    REGION_PAGE_SIZE(order));
+#else
+        new_page = __real_malloc(REGION_PAGE_SIZE(order));
+#endif
 
         if (new_page == NULL) {
 #ifdef SCM_DEBUG
@@ -548,22 +769,47 @@ static region_page_t* init_region_page(region_t* region) {
             exit(-1);
         }
 
+#if defined(SCM_HEADERLESS_REGIONS) || defined(SCM_REGION_PAGE_CHUNKS)
+        // fresh units of the arena and pages of chunks are mapped zero,
+        // units that were handed back to the arena still know their
+        // dirty memory
+        if (new_page->dirty_end == NULL) {
+            new_page->dirty_end = new_page->memory;
+        }
+#else
+        new_page->dirty_end = new_page->memory + REGION_PAGE_PAYLOAD_SIZE(order);
+#endif
+
 #ifdef SCM_RECORD_MEMORY_USAGE
-        inc_overhead(__real_malloc_usable_size(new_page) - SCM_REGION_PAGE_PAYLOAD_SIZE);
-        inc_allocated_mem(__real_malloc_usable_size(new_page));
+        new_page->order = order;
+        inc_overhead(REGION_PAGE_USABLE_SIZE(new_page) - REGION_PAGE_PAYLOAD_SIZE(order));
+        inc_allocated_mem(REGION_PAGE_USABLE_SIZE(new_page));
 #endif
     }
 
-    memset(new_page, '\0', SCM_REGION_PAGE_SIZE);
+    mark_region_page_dirty(region);
+
+    new_page->nextPage = NULL;
+    new_page->order = order;
+
+#ifdef SCM_HEADERLESS_REGIONS
+    tag_region_page(new_page, region);
+#endif
 
     if (prevLastPage != NULL) {
         prevLastPage->nextPage = new_page;
     }
 
-    region->last_address_in_last_page = new_page->memory + SCM_REGION_PAGE_PAYLOAD_SIZE;
+    region->last_address_in_last_page =
+        new_page->memory + REGION_PAGE_PAYLOAD_SIZE(order);
     region->lastPage = new_page;
     region->number_of_region_pages++;
 
+    //the pages of a region grow geometrically up to max_page_order
+    if (region->page_order < region->max_page_order) {
+        region->page_order++;
+    }
+
 // check post-conditions
 #ifdef SCM_CHECK_CONDITIONS
     if (region == NULL) {
@@ -579,13 +825,29 @@ static region_page_t* init_region_page(region_t* region) {
 }
 
 /**
- * scm_create_region() returns a const integer representing a new region
+ * Returns the order of the next page of a region whose last page has the
+ * given order, bounded by min_order and max_order.
+ */
+static inline unsigned int bound_page_order(unsigned long order,
+        unsigned int min_order, unsigned int max_order) {
+    if (order < min_order) {
+        return min_order;
+    }
+    if (order > max_order) {
+        return max_order;
+    }
+    return order;
+}
+
+/**
+ * create_region() returns a const integer representing a new region
  * if available and -1 otherwise. The new region is detected by scanning
  * the descriptor_root regions array for a region that
  * does not yet have any region_page. If such a region is found,
- * a region_page is created and initialized.
+ * a region_page is created and initialized. The pages of the region
+ * start with order min_order and grow up to order max_order.
  */
-const int scm_create_region() {
+static const int create_region(unsigned int min_order, unsigned int max_order) {
     if (SCM_MAX_REGIONS < 1) {
 #ifdef SCM_DEBUG
         printf("libscm was built without region support. Set SCM_MAX_REGIONS to > 0 to use regions.\n");
@@ -606,6 +868,10 @@ const int scm_create_region() {
         // and dc == 0, we can reuse the region.
         if (region->age != descriptor_root->current_time && region->dc == 0) {
             region->age = descriptor_root->current_time;
+            region->zero_memory = true;
+            region->max_page_order = max_order;
+            region->page_order = bound_page_order(region->lastPage->order + 1,
+                                                  min_order, max_order);
 
             descriptor_root->next_reg_index = (i + 1) % SCM_MAX_REGIONS;
 
@@ -626,10 +892,15 @@ const int scm_create_region() {
     
     descriptor_root->next_reg_index = (i + 1) % SCM_MAX_REGIONS;
     region->age = descriptor_root->current_time;
+    region->zero_memory = true;
+    region->page_order = min_order;
+    region->max_page_order = max_order;
     
     region_page_t* page = init_region_page(region);
     region->firstPage = page;
     region->next_free_address = page->memory;
+    region->last_object = NULL;
+    region->oversized_pages = NULL;
 
 // check post-conditions
 #ifdef SCM_CHECK_CONDITIONS
@@ -646,6 +917,30 @@ const int scm_create_region() {
     return (const int) i;
 }
 
+/**
+ * scm_create_region() creates a region whose pages grow geometrically from
+ * SCM_REGION_PAGE_SIZE bytes up to SCM_REGION_PAGE_SIZE << SCM_REGION_PAGE_MAX_ORDER
+ * bytes.
+ */
+const int scm_create_region() {
+    return create_region(0, SCM_REGION_PAGE_MAX_ORDER);
+}
+
+/**
+ * scm_create_region_with_page_size() creates a region whose pages all
+ * have the smallest supported size of at least page_size bytes.
+ */
+const int scm_create_region_with_page_size(size_t page_size) {
+    unsigned int order = 0;
+
+    while (order < SCM_REGION_PAGE_MAX_ORDER
+            && REGION_PAGE_SIZE(order) < page_size) {
+        order++;
+    }
+
+    return create_region(order, order);
+}
+
 /**
  * scm_unregister_region() sets the age of the region back to a 
  * value that is not equal to the descriptor_root current_time. 
@@ -672,31 +967,171 @@ inline void *scm_malloc(size_t size) {
 }
 
 /**
- * scm_malloc_in_region() allocates memory in a region.
+ * scm_malloc_sharded() allocates an object whose descriptors are counted
+ * in per-thread shards, or a regular object without SCM_SHARDED_COUNTERS.
+ */
+void *scm_malloc_sharded(size_t size) {
+#ifdef SCM_SHARDED_COUNTERS
+    object_header_t *object = sharded_malloc(size);
+
+    if (object == NULL) {
+        return NULL;
+    }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    print_memory_consumption();
+#endif
+
+    return PAYLOAD_OFFSET(object);
+#else
+    return __wrap_malloc_internal(size);
+#endif
+}
+
+void *scm_malloc_aligned(size_t size, size_t alignment) {
+    if (!IS_POWER_OF_TWO(alignment)) {
+#ifdef SCM_DEBUG
+        printf("Alignment must be a power of two.\n");
+#endif
+        return NULL;
+    }
+
+    return __wrap_memalign_internal(alignment, size);
+}
+
+#ifdef SCM_HEADERLESS_REGIONS
+// region objects share the object header of their region page
+#define REGION_OBJECT_HEADER_SIZE 0
+#else
+#define REGION_OBJECT_HEADER_SIZE sizeof(object_header_t)
+#endif
+
+// the aligned payload of a region object allocated at or after _address
+#define ALIGNED_REGION_PAYLOAD(_address, _alignment) \
+    ((void*) ROUND_UP((uintptr_t) (_address) + REGION_OBJECT_HEADER_SIZE, \
+        (uintptr_t) (_alignment)))
+
+/**
+ * malloc_oversized_in_region() allocates an object that does not fit into a
+ * region page in an oversized page, which is linked into the region.
+ * A pooled oversized page is re-used if it is large enough. The payload is
+ * zeroed if zero is set. Fresh pages are allocated with calloc, which does
+ * not touch memory that is mapped zero.
+ */
+static void* malloc_oversized_in_region(region_t* region, size_t size,
+                                        size_t alignment, const int region_index,
+                                        bool zero) {
+    size_t needed_size = sizeof(oversized_page_t) + sizeof(object_header_t)
+        + size + alignment;
+
+    if (needed_size < size) {
+#ifdef SCM_DEBUG
+        printf("The region allocator does not support memory of this size.\n");
+#endif
+        return NULL;
+    }
+
+    //first fit in the pool of oversized pages
+    oversized_page_t** link = &descriptor_root->oversized_page_pool;
+
+    while (*link != NULL && (*link)->size < needed_size) {
+        link = &(*link)->next;
+    }
+
+    oversized_page_t* page = *link;
+
+    if (page != NULL) {
+        *link = page->next;
+        descriptor_root->number_of_pooled_oversized_pages--;
+#ifdef SCM_RECORD_MEMORY_USAGE
+        dec_pooled_mem(page->size);
+#endif
+    } else {
+        page = zero ? __real_calloc(1, needed_size) : __real_malloc(needed_size);
+        zero = false;
+
+        if (page == NULL) {
+#ifdef SCM_DEBUG
+            printf("Memory for oversized page could not be allocated.\n");
+#endif
+            return NULL;
+        }
+
+        page->size = __real_malloc_usable_size(page);
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+        inc_allocated_mem(page->size);
+#endif
+    }
+
+    void* payload = (void*) ROUND_UP((uintptr_t) (page + 1)
+        + sizeof(object_header_t), (uintptr_t) alignment);
+    object_header_t* object = (object_header_t*) (payload - sizeof(object_header_t));
+
+    object->dc_or_region_id = region_index | HB_MASK;
+    object->region_object_size = OVERSIZED_REGION_OBJECT;
+
+    if (zero) {
+        memset(payload, '\0', size);
+    }
+
+    page->object_size = size;
+    page->next = region->oversized_pages;
+    region->oversized_pages = page;
+
+    return payload;
+}
+
+/**
+ * zero_region_memory() zeroes the part of size bytes at payload in the last
+ * page of a region that is in front of the dirty_end of the page. Memory
+ * behind dirty_end is still zero.
+ */
+static inline void zero_region_memory(region_t* region, void* payload, size_t size) {
+    void* dirty_end = region->lastPage->dirty_end;
+
+    if (payload < dirty_end) {
+        size_t dirty_size = dirty_end - payload;
+
+        memset(payload, '\0', size < dirty_size ? size : dirty_size);
+    }
+}
+
+/**
+ * malloc_in_region() allocates memory in a region.
  * It adds space for an object header to
  * the requested memory and initializes the
- * memory header.
+ * memory header. With SCM_HEADERLESS_REGIONS the objects share the
+ * object header of their region page instead.
  *
  * Every memory allocation request is aligned to
- * a word to effectively use cache lines.
+ * a word to effectively use cache lines. The payload is aligned to
+ * alignment bytes, which must be a power of two, by skipping
+ * memory in front of the object header.
  *
- * If the requested amount of memory is bigger than the
- * max region_page payload size, scm_malloc_in_region() returns NULL.
+ * If the requested amount of memory plus the alignment padding is bigger
+ * than the max region_page payload size, the object is allocated in an
+ * oversized page of its own.
+ * The payload is zeroed if zero is set or the region zeroes its memory.
  * If the region does not contain at least one
  * region_page it was not correctly initialized and
- * scm_malloc_in_region() returns a NULL pointer.
+ * malloc_in_region() returns a NULL pointer.
  */
-void* scm_malloc_in_region(size_t size, const int region_index) {
-    size_t requested_size = size + sizeof(object_header_t);
+static void* malloc_in_region(size_t size, size_t alignment,
+                              const int region_index, bool zero) {
+    size_t requested_size = size + REGION_OBJECT_HEADER_SIZE;
     unsigned int needed_space = CACHEALIGN(requested_size);
 
-    if (needed_space > SCM_REGION_PAGE_PAYLOAD_SIZE) {
+    if (!IS_POWER_OF_TWO(alignment)) {
 #ifdef SCM_DEBUG
-        printf("The region allocator does not support memory of this size.\n");
+        printf("Alignment must be a power of two.\n");
 #endif
         return NULL;
     }
 
+    //region memory is word aligned, larger alignments may need padding
+    size_t max_padding = alignment > sizeof(long) ? alignment - sizeof(long) : 0;
+
     if (region_index < 0 || region_index >= SCM_MAX_REGIONS) {
 #ifdef SCM_DEBUG
         printf("Region index is invalid.\n");
@@ -728,24 +1163,47 @@ void* scm_malloc_in_region(size_t size, const int region_index) {
     region_t* invar_region = region;
 #endif
 
-    object_header_t* new_obj = region->next_free_address;
-    region->next_free_address += needed_space;
+    zero = zero || region->zero_memory;
+
+    //the object must fit into the next page of the region
+    if (CACHEALIGN(requested_size) + max_padding
+            > REGION_PAGE_PAYLOAD_SIZE(region->page_order)) {
+        return malloc_oversized_in_region(region, size, alignment,
+                                          region_index, zero);
+    }
+
+    void* payload = ALIGNED_REGION_PAYLOAD(region->next_free_address, alignment);
+    void* next_free_address = payload - REGION_OBJECT_HEADER_SIZE + needed_space;
 
     // check if the requested size fits into the region page
-    if(region->next_free_address > region->last_address_in_last_page) {
+    if(next_free_address > region->last_address_in_last_page) {
         // slow allocation
 #ifdef SCM_DEBUG
-        printf("Page is full.\n Creating new page...[new region_page (%u)].\n", SCM_REGION_PAGE_SIZE);
+        printf("Page is full.\n Creating new page...[new region_page (%lu)].\n",
+               (unsigned long) REGION_PAGE_SIZE(region->page_order));
 #endif
         // allocate new page
         region_page_t* page = init_region_page(region);
 
-        new_obj = (object_header_t*) page->memory;
-        region->next_free_address = page->memory + needed_space;
+        payload = ALIGNED_REGION_PAYLOAD(page->memory, alignment);
+        next_free_address = payload - REGION_OBJECT_HEADER_SIZE + needed_space;
     }
 
+    region->next_free_address = next_free_address;
+
+    if (zero) {
+        zero_region_memory(region, payload, size);
+    }
+
+#ifndef SCM_HEADERLESS_REGIONS
+    object_header_t* new_obj = OBJECT_HEADER(payload);
+
     new_obj->dc_or_region_id = region_index | HB_MASK;
-    new_obj->finalizer_index = -1;
+    new_obj->region_object_size = size;
+#endif
+
+    region->last_object = payload;
+    region->last_object_size = size;
 
 // check post-conditions
 #ifdef SCM_CHECK_CONDITIONS
@@ -753,7 +1211,7 @@ void* scm_malloc_in_region(size_t size, const int region_index) {
         printf("The region or the first region page changed during initialization.\n");
         return NULL;
     }
-    if (new_obj == NULL) {
+    if (payload == NULL) {
         printf("Error during allocation. Object is NULL.\n");
         return NULL;
     }
@@ -764,20 +1222,256 @@ void* scm_malloc_in_region(size_t size, const int region_index) {
     }
 #endif
 
-    return PAYLOAD_OFFSET(new_obj);
+    return payload;
 }
 
-inline void scm_free(void *ptr) {
-    __wrap_free_internal(ptr);
+/**
+ * scm_malloc_in_region_aligned() allocates memory in a region whose payload
+ * is aligned to alignment bytes.
+ */
+void* scm_malloc_in_region_aligned(size_t size, size_t alignment, const int region_index) {
+    return malloc_in_region(size, alignment, region_index, false);
 }
 
 /**
- * Collects descriptors incrementally
+ * scm_malloc_in_region() allocates memory in a region whose payload is
+ * aligned to SCM_REGION_OBJECT_ALIGNMENT.
  */
-static void lazy_collect(void) {
-    expire_object_descriptor_if_exists(&descriptor_root->list_of_expired_obj_descriptors);
-
-    expire_region_descriptor_if_exists(&descriptor_root->list_of_expired_reg_descriptors);
+void* scm_malloc_in_region(size_t size, const int region_index) {
+    return malloc_in_region(size, SCM_REGION_OBJECT_ALIGNMENT,
+                            region_index, false);
+}
+
+/**
+ * scm_calloc_in_region() allocates zeroed memory for nelem elements of
+ * elsize bytes in a region. Only memory that was dirtied since the
+ * region page was last zeroed is cleared.
+ */
+void* scm_calloc_in_region(size_t nelem, size_t elsize, const int region_index) {
+    if (elsize != 0 && nelem > (size_t) -1 / elsize) {
+#ifdef SCM_DEBUG
+        printf("The region allocator does not support memory of this size.\n");
+#endif
+        return NULL;
+    }
+
+    return malloc_in_region(nelem * elsize, SCM_REGION_OBJECT_ALIGNMENT,
+                            region_index, true);
+}
+
+/**
+ * scm_set_region_zeroing() sets whether the objects of a region are
+ * zeroed on allocation.
+ */
+void scm_set_region_zeroing(const int region_index, const int zero_memory) {
+    if (region_index < 0 || region_index >= SCM_MAX_REGIONS) {
+#ifdef SCM_DEBUG
+        printf("Region index is invalid.\n");
+#endif
+        return;
+    }
+
+    create_descriptor_root();
+
+    descriptor_root->regions[region_index].zero_memory = zero_memory != 0;
+}
+
+/**
+ * realloc_in_region() resizes an object of a region.
+ * The most recent allocation of the region grows or shrinks in place
+ * as long as it fits into the last region page. Other objects are copied
+ * into a new object of the same region, which keeps the alignment of the
+ * old object up to the new size rounded up to a power of two.
+ *
+ * Objects in region pages find their size in their object header, objects
+ * in oversized pages in the page, which is found by walking the oversized
+ * pages of the region. With SCM_HEADERLESS_REGIONS only the size of the
+ * most recent allocation is known, other objects cannot be resized.
+ * Memory that an object grows into is zeroed if the region zeroes its
+ * memory.
+ */
+static void* realloc_in_region(void *ptr, size_t size, const int region_index) {
+
+    if (descriptor_root == NULL
+            || region_index < 0 || region_index >= SCM_MAX_REGIONS) {
+#ifdef SCM_DEBUG
+        printf("Cannot reallocate object of an unknown region.\n");
+#endif
+        return NULL;
+    }
+
+    region_t* region = &descriptor_root->regions[region_index];
+
+    if (ptr == region->last_object) {
+        size_t old_size = region->last_object_size;
+        void* old_end = region->next_free_address;
+        void* new_end = ptr - REGION_OBJECT_HEADER_SIZE
+            + CACHEALIGN(size + REGION_OBJECT_HEADER_SIZE);
+
+        if (new_end <= region->last_address_in_last_page) {
+            if (new_end < old_end) {
+                //a shrinking object leaves dirty memory behind
+                mark_region_page_dirty(region);
+            }
+
+            region->next_free_address = new_end;
+            region->last_object_size = size;
+#ifndef SCM_HEADERLESS_REGIONS
+            object_header_t* object = OBJECT_HEADER(ptr);
+
+            object->region_object_size = size;
+#endif
+
+            if (size > old_size && region->zero_memory) {
+                zero_region_memory(region, ptr + old_size, size - old_size);
+            }
+
+            return ptr;
+        }
+    }
+
+    size_t old_size = region->last_object_size;
+
+    if (ptr != region->last_object) {
+#ifdef SCM_HEADERLESS_REGIONS
+        if (arena_contains(&region_page_arena, ptr)) {
+#ifdef SCM_DEBUG
+            printf("Objects without object header do not record their size.\n");
+#endif
+            return NULL;
+        }
+#endif
+        object_header_t* object = OBJECT_HEADER(ptr);
+
+        old_size = object->region_object_size;
+
+        if (old_size == OVERSIZED_REGION_OBJECT) {
+            oversized_page_t* oversized_page = region->oversized_pages;
+
+            while (oversized_page != NULL
+                    && !(ptr > (void*) oversized_page
+                         && ptr < (void*) oversized_page + oversized_page->size)) {
+                oversized_page = oversized_page->next;
+            }
+
+            if (oversized_page == NULL) {
+#ifdef SCM_DEBUG
+                printf("Object is not allocated in region %d.\n", region_index);
+#endif
+                return NULL;
+            }
+
+            old_size = oversized_page->object_size;
+        }
+    }
+
+    //the alignment of the old object is at least the requested alignment,
+    //but an object that happens to start at a page boundary was hardly
+    //requested with page alignment, so alignments beyond the new size
+    //rounded up to a power of two are not kept
+    size_t address_alignment = (uintptr_t) ptr & -(uintptr_t) ptr;
+    size_t alignment = SCM_REGION_OBJECT_ALIGNMENT;
+
+    while (alignment < size && alignment < address_alignment) {
+        alignment <<= 1;
+    }
+
+    void* new_ptr = malloc_in_region(size, alignment, region_index, false);
+
+    if (new_ptr != NULL) {
+        memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+    }
+
+    return new_ptr;
+}
+
+inline void scm_free(void *ptr) {
+    __wrap_free_internal(ptr);
+}
+
+/**
+ * Returns the number of descriptor slots of expired descriptors that are
+ * not collected yet. A slot is a descriptor unless compressed descriptors
+ * take two slots for full pointers.
+ */
+static inline size_t collect_backlog(void) {
+    return descriptor_root->list_of_expired_obj_descriptors.pending
+        + descriptor_root->list_of_expired_reg_descriptors.pending;
+}
+
+/**
+ * Collects descriptors of up to count descriptor slots, alternating
+ * between object and region descriptors as lazy_collect does. Returns the
+ * number of descriptor slots collected.
+ */
+static size_t bounded_collect(size_t count) {
+    size_t backlog = collect_backlog();
+    size_t collected = 0;
+
+    while (collected < count) {
+        int progress = expire_object_descriptor_if_exists(
+            &descriptor_root->list_of_expired_obj_descriptors);
+
+        collected = backlog - collect_backlog();
+
+        if (collected < count && expire_region_descriptor_if_exists(
+                &descriptor_root->list_of_expired_reg_descriptors)) {
+            collected = backlog - collect_backlog();
+            progress = 1;
+        }
+
+        if (!progress) {
+            break;
+        }
+    }
+
+    return collected;
+}
+
+#ifdef SCM_COLLECTION_PACER
+/**
+ * Collects descriptors in a step proportional to the number of objects
+ * allocated since the last step, so that frees keep up with allocations.
+ * At ticks, the step additionally drains the backlog of expired
+ * descriptors over SCM_PACER_DRAIN_TICKS ticks. Steps are bounded by
+ * SCM_PACER_MAX_STEP descriptors.
+ */
+static void paced_collect(bool at_tick) {
+    size_t backlog = collect_backlog();
+
+    size_t step = 2 + descriptor_root->pacer_allocations;
+
+    if (at_tick) {
+        step += backlog / SCM_PACER_DRAIN_TICKS;
+    }
+
+    if (step > SCM_PACER_MAX_STEP) {
+        step = SCM_PACER_MAX_STEP;
+    }
+
+    descriptor_root->pacer_allocations = 0;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    size_t collected = bounded_collect(step);
+
+    record_pacer_step(collected, backlog - collected);
+#else
+    bounded_collect(step);
+#endif
+}
+#endif
+
+/**
+ * Collects descriptors incrementally
+ */
+static void lazy_collect(void) {
+#ifdef SCM_COLLECTION_PACER
+    paced_collect(false);
+#else
+    expire_object_descriptor_if_exists(&descriptor_root->list_of_expired_obj_descriptors);
+
+    expire_region_descriptor_if_exists(&descriptor_root->list_of_expired_reg_descriptors);
+#endif
 }
 
 /**
@@ -792,31 +1486,129 @@ static void eager_collect(void) {
 
 inline void scm_collect(void) {
     if (descriptor_root != NULL) {
+#ifdef SCM_BIASED_COUNTING
+        merge_queued_objects();
+#endif
+#ifdef SCM_BACKGROUND_RECLAIMER
+        wait_for_reclaimer();
+#endif
         eager_collect();
     }
 }
 
+// the number of descriptor slots collected between two reads of the clock
+#define COLLECT_CLOCK_INTERVAL 32
+
+size_t scm_collect_n(size_t count) {
+    if (descriptor_root == NULL) {
+        return 0;
+    }
+
+#ifdef SCM_BIASED_COUNTING
+    merge_queued_objects();
+#endif
+
+    bounded_collect(count);
+
+    return collect_backlog();
+}
+
+/**
+ * Returns the current time of the monotonic clock in nanoseconds
+ */
+static inline unsigned long long monotonic_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+size_t scm_collect_for_ns(unsigned long long budget_ns) {
+    if (descriptor_root == NULL) {
+        return 0;
+    }
+
+    unsigned long long deadline = monotonic_ns() + budget_ns;
+
+#ifdef SCM_BIASED_COUNTING
+    merge_queued_objects();
+#endif
+
+    //the clock is read once per interval, so the budget may be exceeded
+    //by the time it takes to collect COLLECT_CLOCK_INTERVAL slots
+    while (monotonic_ns() < deadline) {
+        if (bounded_collect(COLLECT_CLOCK_INTERVAL) < COLLECT_CLOCK_INTERVAL) {
+            break;
+        }
+    }
+
+    return collect_backlog();
+}
+
 /**
  * Checks whether the given extension time is in the bounds of the allowed
  * extension time.
  */
 static inline unsigned int check_extension(unsigned int given_extension) {
-    if (given_extension > SCM_MAX_EXPIRATION_EXTENSION) {
+    if (given_extension > max_expiration_extension) {
 #ifdef SCM_DEBUG
-        printf("Violation of SCM_MAX_EXPIRATION_EXTENSION.\n");
+        printf("Violation of the maximal expiration extension.\n");
 #endif
-        return SCM_MAX_EXPIRATION_EXTENSION;
+        return max_expiration_extension;
     } else {
         return given_extension;
     }
 }
 
+#ifdef SCM_REFRESH_COALESCING
+/**
+ * Records in the refresh cache that the object has a live descriptor
+ * with the given clock that expires after the extension.
+ */
+static inline void remember_refresh(object_header_t* object,
+        unsigned int extension, const unsigned int clock) {
+    refresh_cache_entry_t* entry =
+        &descriptor_root->refresh_cache[REFRESH_CACHE_INDEX(object, clock)];
+
+    entry->object = object;
+    entry->clock = clock;
+    entry->expiration =
+        descriptor_root->locally_clocked_obj_buffer[clock].ticks + extension;
+}
+
+/**
+ * Returns true iff the refresh cache knows a live descriptor of the object
+ * with the given clock that does not expire before the extension.
+ * Otherwise the refresh is recorded in the cache.
+ */
+static inline bool is_coalesced_refresh(object_header_t* object,
+        unsigned int extension, const unsigned int clock) {
+    unsigned long expiration =
+        descriptor_root->locally_clocked_obj_buffer[clock].ticks + extension;
+    refresh_cache_entry_t* entry =
+        &descriptor_root->refresh_cache[REFRESH_CACHE_INDEX(object, clock)];
+
+    if (entry->object == object && entry->clock == clock
+            && entry->expiration >= expiration) {
+        return true;
+    }
+
+    remember_refresh(object, extension, clock);
+
+    return false;
+}
+#endif
+
 /**
  * scm_refresh_with_clock() refreshes a given object with a given clock,
  * which can be different to the thread-local base clock.
  * If an object is refreshed with multiple clocks it lives
  * until all clocks ticked n times, where n is the respective extension.
  * If the object is part of a region, the region is refreshed instead.
+ * With SCM_REFRESH_COALESCING no descriptor is inserted if the refresh cache
+ * knows a descriptor of the object with the same clock that does not
+ * expire earlier.
  */
 void scm_refresh_with_clock(void *ptr, unsigned int extension, const unsigned int clock) {
     MICROBENCHMARK_START
@@ -836,13 +1628,6 @@ void scm_refresh_with_clock(void *ptr, unsigned int extension, const unsigned in
 
         scm_refresh_region_with_clock(region_id, extension, clock);
     } else {
-        if (object->dc_or_region_id == INT_MAX) {
-#ifdef SCM_DEBUG
-            printf("Descriptor counter reached max value.\n");
-#endif
-            return;
-        }
-
         extension = check_extension(extension);
 
         if (clock < 0 || clock >= SCM_MAX_CLOCKS) {
@@ -854,6 +1639,13 @@ void scm_refresh_with_clock(void *ptr, unsigned int extension, const unsigned in
 
         create_descriptor_root();
 
+        if (is_descriptor_counter_full(object)) {
+#ifdef SCM_DEBUG
+            printf("Descriptor counter reached max value.\n");
+#endif
+            return;
+        }
+
 // check pre-conditions
 #ifdef SCM_CHECK_CONDITIONS
         if (descriptor_root->current_time !=
@@ -865,7 +1657,15 @@ void scm_refresh_with_clock(void *ptr, unsigned int extension, const unsigned in
         }
 #endif
 
-        atomic_int_inc((int*) & object->dc_or_region_id);
+#ifdef SCM_REFRESH_COALESCING
+        if (is_coalesced_refresh(object, extension, clock)) {
+            MICROBENCHMARK_STOP
+            MICROBENCHMARK_DURATION("scm_refresh_with_clock")
+            return;
+        }
+#endif
+
+        increment_descriptor_counter(object);
         insert_descriptor(object,
                           &descriptor_root->locally_clocked_obj_buffer[clock], extension);
 
@@ -895,6 +1695,102 @@ void scm_refresh(void *ptr, unsigned int extension) {
     scm_refresh_with_clock(ptr, extension, 0);
 }
 
+// the number of descriptors that are collected before they are inserted
+#define REFRESH_BATCH_SIZE 64
+
+/**
+ * scm_refresh_many() refreshes n objects with a given clock. The extension
+ * and the clock are checked once, and descriptors are inserted in batches
+ * of REFRESH_BATCH_SIZE. Objects of regions refresh their region instead,
+ * NULL pointers are skipped. Expired descriptors are collected once at the
+ * end.
+ */
+void scm_refresh_many(void **ptrs, size_t n, unsigned int extension,
+                      const unsigned int clock) {
+    MICROBENCHMARK_START
+
+    if (ptrs == NULL || n == 0) {
+        return;
+    }
+
+    extension = check_extension(extension);
+
+    if (clock < 0 || clock >= SCM_MAX_CLOCKS) {
+#ifdef SCM_DEBUG
+        printf("Clock is invalid.\n");
+#endif
+        return;
+    }
+
+    create_descriptor_root();
+
+// check pre-conditions
+#ifdef SCM_CHECK_CONDITIONS
+    if (descriptor_root->current_time !=
+            descriptor_root->locally_clocked_obj_buffer[clock].age ||
+            descriptor_root->locally_clocked_obj_buffer[clock]
+            .not_expired_length == 0) {
+        printf("Cannot refresh zombie clock.\n");
+        return;
+    }
+#endif
+
+    void* batch[REFRESH_BATCH_SIZE];
+    unsigned long batched = 0;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (ptrs[i] == NULL) {
+            continue;
+        }
+
+        object_header_t* object = OBJECT_HEADER(ptrs[i]);
+
+        if (object->dc_or_region_id < 0) {
+            refresh_region(object->dc_or_region_id & ~HB_MASK, extension, clock);
+            continue;
+        }
+
+        if (is_descriptor_counter_full(object)) {
+#ifdef SCM_DEBUG
+            printf("Descriptor counter reached max value.\n");
+#endif
+            continue;
+        }
+
+#ifdef SCM_REFRESH_COALESCING
+        if (is_coalesced_refresh(object, extension, clock)) {
+            continue;
+        }
+#endif
+
+        increment_descriptor_counter(object);
+        batch[batched++] = object;
+
+        if (batched == REFRESH_BATCH_SIZE) {
+            insert_descriptors(batch, batched,
+                &descriptor_root->locally_clocked_obj_buffer[clock], extension);
+            batched = 0;
+        }
+    }
+
+    insert_descriptors(batch, batched,
+        &descriptor_root->locally_clocked_obj_buffer[clock], extension);
+
+#ifndef SCM_EAGER_COLLECTION
+    lazy_collect();
+#else
+    //do nothing. expired descriptors are collected at tick
+#endif
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    print_memory_consumption();
+#endif
+
+    MICROBENCHMARK_STOP
+    MICROBENCHMARK_DURATION("scm_refresh_many")
+}
+
 /**
  * scm_global_refresh adds extension time units + 2 to the expiration time of
  * ptr making sure that all other threads have enough time to also call
@@ -918,18 +1814,18 @@ void scm_global_refresh(void *ptr, unsigned int extension) {
 
         scm_global_refresh_region(region_id, extension);
     } else {
-        if (object->dc_or_region_id == INT_MAX) {
+        extension = check_extension(extension);
+
+        create_descriptor_root();
+
+        if (is_descriptor_counter_full(object)) {
 #ifdef SCM_DEBUG
             printf("Descriptor counter reached max value.\n");
 #endif
             return;
         }
 
-        extension = check_extension(extension);
-
-        create_descriptor_root();
-
-        atomic_int_inc((int*) &object->dc_or_region_id);
+        increment_descriptor_counter(object);
         insert_descriptor(object,
                           &descriptor_root->globally_clocked_obj_buffer, extension + 2);
 
@@ -949,19 +1845,14 @@ void scm_global_refresh(void *ptr, unsigned int extension) {
 }
 
 /**
- * scm_refresh_region_with_clock() refreshes a given region with a given
- * clock, which can be different from the thread-local base clock.
- * If a region is refreshed with multiple clocks it lives
- * until all clocks ticked n times, where n is the respective extension.
+ * scm_malloc_refreshed() allocates a short-term memory object and refreshes
+ * it with a given clock. No other thread can know the object yet, so its
+ * descriptor counter is set without an atomic increment and the descriptor
+ * is inserted directly.
  */
-void scm_refresh_region_with_clock(const int region_index, unsigned int extension, const unsigned int clock) {
-
-    if (region_index < 0 || region_index >= SCM_MAX_REGIONS) {
-#ifdef SCM_DEBUG
-        printf("Region index is invalid.\n");
-#endif
-        return;
-    }
+void *scm_malloc_refreshed(size_t size, unsigned int extension,
+                           const unsigned int clock) {
+    MICROBENCHMARK_START
 
     extension = check_extension(extension);
 
@@ -969,11 +1860,64 @@ void scm_refresh_region_with_clock(const int region_index, unsigned int extensio
 #ifdef SCM_DEBUG
         printf("Clock is invalid.\n");
 #endif
-        return;
+        return NULL;
     }
 
     create_descriptor_root();
 
+// check pre-conditions
+#ifdef SCM_CHECK_CONDITIONS
+    if (descriptor_root->current_time !=
+            descriptor_root->locally_clocked_obj_buffer[clock].age ||
+            descriptor_root->locally_clocked_obj_buffer[clock]
+            .not_expired_length == 0) {
+        printf("Cannot refresh zombie clock.\n");
+        return NULL;
+    }
+#endif
+
+    void *ptr = __wrap_malloc_internal(size);
+
+    if (ptr == NULL) {
+        return NULL;
+    }
+
+    object_header_t* object = OBJECT_HEADER(ptr);
+
+#ifdef SCM_BIASED_COUNTING
+    if (is_biased(object)) {
+        object->biased_dc = 1;
+    } else {
+        object->dc_or_region_id = DC_MERGED + 1;
+    }
+#else
+    object->dc_or_region_id = 1;
+#endif
+    insert_descriptor(object,
+                      &descriptor_root->locally_clocked_obj_buffer[clock], extension);
+
+#ifdef SCM_REFRESH_COALESCING
+    remember_refresh(object, extension, clock);
+#endif
+
+#ifndef SCM_EAGER_COLLECTION
+    lazy_collect();
+#else
+    //do nothing. expired descriptors are collected at tick
+#endif
+
+    MICROBENCHMARK_STOP
+    MICROBENCHMARK_DURATION("scm_malloc_refreshed")
+
+    return ptr;
+}
+
+/**
+ * refresh_region() inserts a descriptor for a valid region index with
+ * a checked extension and clock, without collecting.
+ */
+static void refresh_region(const int region_index, unsigned int extension,
+                           const unsigned int clock) {
     region_t* region = &descriptor_root->regions[region_index];
 
     if (region->dc == INT_MAX) {
@@ -996,6 +1940,35 @@ void scm_refresh_region_with_clock(const int region_index, unsigned int extensio
     atomic_int_inc((int*) &region->dc);
     insert_descriptor(region,
                       &descriptor_root->locally_clocked_reg_buffer[clock], extension);
+}
+
+/**
+ * scm_refresh_region_with_clock() refreshes a given region with a given
+ * clock, which can be different from the thread-local base clock.
+ * If a region is refreshed with multiple clocks it lives
+ * until all clocks ticked n times, where n is the respective extension.
+ */
+void scm_refresh_region_with_clock(const int region_index, unsigned int extension, const unsigned int clock) {
+
+    if (region_index < 0 || region_index >= SCM_MAX_REGIONS) {
+#ifdef SCM_DEBUG
+        printf("Region index is invalid.\n");
+#endif
+        return;
+    }
+
+    extension = check_extension(extension);
+
+    if (clock < 0 || clock >= SCM_MAX_CLOCKS) {
+#ifdef SCM_DEBUG
+        printf("Clock is invalid.\n");
+#endif
+        return;
+    }
+
+    create_descriptor_root();
+
+    refresh_region(region_index, extension, clock);
 
 #ifndef SCM_EAGER_COLLECTION
     lazy_collect();
@@ -1018,6 +1991,91 @@ void scm_refresh_region(const int region_index, unsigned int extension) {
     scm_refresh_region_with_clock(region_index, extension, 0);
 }
 
+/**
+ * scm_malloc_in_region_refreshed() allocates memory in a region and
+ * refreshes the region with a given clock. Expired descriptors are
+ * collected once for both.
+ */
+void *scm_malloc_in_region_refreshed(size_t size, const int region_index,
+                                     unsigned int extension,
+                                     const unsigned int clock) {
+    extension = check_extension(extension);
+
+    if (clock < 0 || clock >= SCM_MAX_CLOCKS) {
+#ifdef SCM_DEBUG
+        printf("Clock is invalid.\n");
+#endif
+        return NULL;
+    }
+
+    void *ptr = malloc_in_region(size, SCM_REGION_OBJECT_ALIGNMENT,
+                                 region_index, false);
+
+    if (ptr == NULL) {
+        return NULL;
+    }
+
+    refresh_region(region_index, extension, clock);
+
+#ifndef SCM_EAGER_COLLECTION
+    lazy_collect();
+#else
+    //do nothing. expired descriptors are collected at tick
+#endif
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    print_memory_consumption();
+#endif
+
+    return ptr;
+}
+
+/**
+ * scm_refresh_region_many() refreshes n regions with a given clock. The
+ * extension and the clock are checked once, and expired descriptors are
+ * collected once at the end. Invalid region indices are skipped.
+ */
+void scm_refresh_region_many(const int *region_indices, size_t n,
+                             unsigned int extension, const unsigned int clock) {
+    if (region_indices == NULL || n == 0) {
+        return;
+    }
+
+    extension = check_extension(extension);
+
+    if (clock < 0 || clock >= SCM_MAX_CLOCKS) {
+#ifdef SCM_DEBUG
+        printf("Clock is invalid.\n");
+#endif
+        return;
+    }
+
+    create_descriptor_root();
+
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (region_indices[i] < 0 || region_indices[i] >= SCM_MAX_REGIONS) {
+#ifdef SCM_DEBUG
+            printf("Region index is invalid.\n");
+#endif
+            continue;
+        }
+
+        refresh_region(region_indices[i], extension, clock);
+    }
+
+#ifndef SCM_EAGER_COLLECTION
+    lazy_collect();
+#else
+    //do nothing. expired descriptors are collected at tick
+#endif
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    print_memory_consumption();
+#endif
+}
+
 /**
  * scm_global_refresh_region() adds extension time units + 2 to
  * the expiration time of a region making sure that all other threads have
@@ -1079,8 +2137,12 @@ static void increment_and_expire_clock(const unsigned int clock) {
 
     //expire_buffer operates on current_index - 1, so it is called after
     //we incremented the current_index of the locally_clocked_buffer
+#ifdef SCM_BACKGROUND_RECLAIMER
+    hand_over_expired_buffer(&descriptor_root->locally_clocked_obj_buffer[clock]);
+#else
     expire_buffer(&descriptor_root->locally_clocked_obj_buffer[clock],
                   &descriptor_root->list_of_expired_obj_descriptors);
+#endif
     expire_buffer(&descriptor_root->locally_clocked_reg_buffer[clock],
                   &descriptor_root->list_of_expired_reg_descriptors);
 }
@@ -1143,14 +2205,28 @@ void scm_tick_clock(const unsigned int clock) {
         }
     }
 
+#ifdef SCM_BIASED_COUNTING
+    merge_queued_objects();
+#endif
+
+#ifdef SCM_BACKGROUND_RECLAIMER
+    recycle_reclaimed_descriptor_pages();
+#endif
+
 #ifdef SCM_EAGER_COLLECTION
     eager_collect();
+#elif defined(SCM_COLLECTION_PACER)
+    paced_collect(true);
 #else
     //we also process expired descriptors at tick
     //to get a cyclic allocation/free scheme. this is optional
     lazy_collect();
 #endif
 
+#ifdef SCM_ADAPTIVE_PAGE_POOLS
+    resize_page_pools();
+#endif
+
 #ifdef SCM_RECORD_MEMORY_USAGE
     print_memory_consumption();
 #endif
@@ -1191,8 +2267,12 @@ void scm_global_tick(void) {
 
         //expire_buffer operates on current_index - 1, so it is called after
         //we incremented the current_index of the globally_clocked_buffer
+#ifdef SCM_BACKGROUND_RECLAIMER
+        hand_over_expired_buffer(&descriptor_root->globally_clocked_obj_buffer);
+#else
         expire_buffer(&descriptor_root->globally_clocked_obj_buffer,
                       &descriptor_root->list_of_expired_obj_descriptors);
+#endif
         expire_buffer(&descriptor_root->globally_clocked_reg_buffer,
                       &descriptor_root->list_of_expired_reg_descriptors);
 
@@ -1243,12 +2323,22 @@ void scm_global_tick(void) {
         }
     }
 
+#ifdef SCM_BIASED_COUNTING
+    merge_queued_objects();
+#endif
+
 #ifdef SCM_EAGER_COLLECTION
     eager_collect();
+#elif defined(SCM_COLLECTION_PACER)
+    paced_collect(true);
 #else
     lazy_collect();
 #endif
 
+#ifdef SCM_BACKGROUND_RECLAIMER
+    recycle_reclaimed_descriptor_pages();
+#endif
+
 #ifdef SCM_RECORD_MEMORY_USAGE
     print_memory_consumption();
 #endif
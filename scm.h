@@ -10,6 +10,9 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
 
 #include <pthread.h>
 #include <limits.h>
@@ -18,6 +21,7 @@
 #include "arch.h"
 #include "object.h"
 #include "descriptors.h"
+#include "reclaimer.h"
 #include "libscm.h"
 
 #ifdef SCM_MAKE_MICROBENCHMARKS
@@ -31,10 +35,10 @@
 #define MICROBENCHMARK_DURATION(_location) //NOOP
 #endif
 
-#define HB_MASK (UINT_MAX - INT_MAX)
-
 #define CACHEALIGN(x) (ROUND_UP(x,8))
 #define ROUND_UP(x,y) (ROUND_DOWN(x+(y-1),y))
 #define ROUND_DOWN(x,y) ((x) & ~(y-1))
 
+#define IS_POWER_OF_TWO(x) ((x) != 0 && ((x) & ((x) - 1)) == 0)
+
 #endif	/* _SCM_H_ */
\ No newline at end of file
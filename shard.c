@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#include "descriptors.h"
+
+#ifdef SCM_SHARDED_COUNTERS
+
+// the number of threads that were assigned a shard so far
+static volatile int number_of_sharing_threads = 0;
+
+object_header_t* sharded_malloc(size_t size) {
+
+    if (size > SIZE_MAX - SHARDED_PREFIX_SIZE) {
+        return NULL;
+    }
+
+    void *chunk = __real_memalign(COUNTER_SHARD_SIZE, SHARDED_PREFIX_SIZE + size);
+
+    if (chunk == NULL) {
+#ifdef SCM_DEBUG
+        printf("memalign failed.\n");
+#endif
+        return NULL;
+    }
+
+    memset(chunk, 0, SCM_COUNTER_SHARDS * COUNTER_SHARD_SIZE);
+
+    object_header_t *object = SHARDED_OBJECT(chunk);
+
+    init_descriptor_counter(object);
+    //counts the shards that are not empty
+    object->dc_or_region_id = 0;
+    object->finalizer_index = -1;
+    object->allocator = OBJECT_ALLOCATOR_SHARDED;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_overhead(SHARDED_PREFIX_SIZE);
+    inc_allocated_mem(__real_malloc_usable_size(chunk));
+#endif
+
+    return object;
+}
+
+void sharded_free(object_header_t *object) {
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_overhead(SHARDED_PREFIX_SIZE);
+    inc_freed_mem(__real_malloc_usable_size(SHARDED_CHUNK(object)));
+#endif
+    __real_free(SHARDED_CHUNK(object));
+}
+
+size_t sharded_usable_size(object_header_t *object) {
+    return __real_malloc_usable_size(SHARDED_CHUNK(object))
+        - SHARDED_PREFIX_SIZE;
+}
+
+unsigned int next_counter_shard() {
+    return (unsigned int) atomic_int_exchange_and_add(&number_of_sharing_threads, 1)
+        % SCM_COUNTER_SHARDS;
+}
+
+#endif  /* SCM_SHARDED_COUNTERS */
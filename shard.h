@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _SHARD_H_
+#define	_SHARD_H_
+
+#ifdef SCM_SHARDED_COUNTERS
+
+#include <stdbool.h>
+
+#include "arch.h"
+#include "object.h"
+#include "libscm.h"
+
+/*
+ * Sharded objects count their descriptors in SCM_COUNTER_SHARDS counters
+ * that are located in separate cache lines in front of the object header.
+ * Each thread counts in its own shard, so refreshes and expirations of
+ * objects that many threads refresh do not contend on one cache line.
+ * The descriptor counter in the object header counts the shards that are
+ * not empty and is only changed when a shard becomes empty or non-empty.
+ * The object has no descriptors anymore once all shards are empty.
+ *
+ * -------------------------  <- pointer to the shards (cache line aligned)
+ * | shard 0               |
+ * ~ ...                   ~
+ * | shard n - 1           |
+ * -------------------------
+ * | object header         |
+ * -------------------------  <- pointer to the payload
+ * | payload data          |
+ * ~                       ~
+ * -------------------------
+ */
+typedef struct counter_shard counter_shard_t;
+
+// the size of a cache line
+#define COUNTER_SHARD_SIZE 64
+
+struct counter_shard {
+    volatile int count;
+    char padding[COUNTER_SHARD_SIZE - sizeof(int)];
+};
+
+#define SHARDED_PREFIX_SIZE \
+    (SCM_COUNTER_SHARDS * COUNTER_SHARD_SIZE + OBJECT_PREFIX_SIZE)
+#define SHARDED_CHUNK(_o) \
+    ((void*)(_o) + sizeof(object_header_t) - SHARDED_PREFIX_SIZE)
+#define SHARDED_OBJECT(_chunk) \
+    ((object_header_t*) ((void*)(_chunk) + SHARDED_PREFIX_SIZE \
+        - sizeof(object_header_t)))
+#define COUNTER_SHARDS(_o) ((counter_shard_t*) SHARDED_CHUNK(_o))
+
+/*
+ * sharded_malloc() allocates a sharded object with empty shards.
+ * Returns NULL if no memory is available.
+ */
+object_header_t* sharded_malloc(size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * sharded_free() frees a sharded object.
+ */
+void sharded_free(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/*
+ * sharded_usable_size() returns the payload size of a sharded object.
+ */
+size_t sharded_usable_size(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/*
+ * next_counter_shard() returns the shard of the next new thread.
+ */
+unsigned int next_counter_shard(void)
+    __attribute__((visibility("hidden")));
+
+/*
+ * increment_sharded_counter() counts a new descriptor in a shard of
+ * a sharded object.
+ */
+static inline void increment_sharded_counter(object_header_t *object,
+        unsigned int shard) {
+    if (atomic_int_exchange_and_add(&COUNTER_SHARDS(object)[shard].count, 1) == 0) {
+        //the shard is not empty anymore
+        atomic_int_inc(&object->dc_or_region_id);
+    }
+}
+
+/*
+ * decrement_sharded_counter_and_test() uncounts an expired descriptor in
+ * a shard of a sharded object and returns true iff all shards are empty.
+ */
+static inline bool decrement_sharded_counter_and_test(object_header_t *object,
+        unsigned int shard) {
+    if (atomic_int_exchange_and_add(&COUNTER_SHARDS(object)[shard].count, -1) != 1) {
+        return false;
+    }
+
+    //the shard is empty now
+    return atomic_int_dec_and_test(&object->dc_or_region_id);
+}
+
+#endif  /* SCM_SHARDED_COUNTERS */
+
+#endif	/* _SHARD_H_ */
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#include "descriptors.h"
+
+#ifdef SCM_SLAB_ALLOCATION
+
+#include <pthread.h>
+
+// free blocks are linked through the first word of their payload
+#define NEXT_FREE_BLOCK(_block) (*(void**) PAYLOAD_OFFSET(_block))
+
+// Blocks that were freed by threads without a descriptor root.
+// They are adopted by the next thread that runs out of blocks.
+static void* orphaned_blocks = NULL;
+
+//protects orphaned_blocks
+static pthread_mutex_t orphaned_blocks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * lock_orphaned_blocks() locks the list of orphaned blocks.
+ */
+static inline void lock_orphaned_blocks() {
+#ifdef SCM_PRINT_BLOCKING
+    if (pthread_mutex_trylock(&orphaned_blocks_lock)) {
+        printf("Thread %p BLOCKS on orphaned_blocks_lock.\n", (void*) pthread_self());
+        pthread_mutex_lock(&orphaned_blocks_lock);
+    }
+#else
+    pthread_mutex_lock(&orphaned_blocks_lock);
+#endif
+}
+
+/**
+ * unlock_orphaned_blocks() releases the lock of the orphaned blocks.
+ */
+static inline void unlock_orphaned_blocks() {
+    pthread_mutex_unlock(&orphaned_blocks_lock);
+}
+
+/**
+ * Returns the size class of an object with size payload bytes. The payload
+ * of a free block must be large enough to link the block.
+ */
+static inline unsigned int get_size_class(size_t size) {
+    if (size < sizeof(void*)) {
+        size = sizeof(void*);
+    }
+
+    return (size + sizeof(object_header_t) - 1) / SLAB_BLOCK_ALIGNMENT;
+}
+
+static inline void push_free_block(slab_class_t *class, object_header_t *block) {
+    NEXT_FREE_BLOCK(block) = class->free_blocks;
+    class->free_blocks = block;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_pooled_mem(SLAB_BLOCK_SIZE(block->allocator_info));
+#endif
+}
+
+/**
+ * Moves all orphaned blocks into the size classes of the calling thread.
+ */
+static void adopt_orphaned_blocks() {
+    //unsynchronized read, we catch up with the orphans at the next refill
+    if (orphaned_blocks == NULL) {
+        return;
+    }
+
+    lock_orphaned_blocks();
+
+    object_header_t *block = orphaned_blocks;
+    orphaned_blocks = NULL;
+
+    unlock_orphaned_blocks();
+
+    while (block != NULL) {
+        object_header_t *next = NEXT_FREE_BLOCK(block);
+
+        push_free_block(&descriptor_root->slab_classes[block->allocator_info],
+                        block);
+
+        block = next;
+    }
+}
+
+/**
+ * Allocates a new slab for the given size class. Returns 0 iff the slab
+ * could not be allocated.
+ */
+static int new_slab(slab_class_t *class) {
+    void *slab = __real_malloc(SCM_SLAB_SIZE);
+
+    if (slab == NULL) {
+#ifdef SCM_DEBUG
+        printf("Allocation of new slab failed.\n");
+#endif
+        return 0;
+    }
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_allocated_mem(__real_malloc_usable_size(slab));
+    inc_pooled_mem(SCM_SLAB_SIZE);
+#endif
+
+    //the first block starts such that all payloads in the slab are aligned
+    unsigned long first_payload = ((unsigned long) slab
+        + sizeof(object_header_t) + SLAB_BLOCK_ALIGNMENT - 1)
+        & ~(unsigned long) (SLAB_BLOCK_ALIGNMENT - 1);
+
+    class->next_free_address = (void*) first_payload - sizeof(object_header_t);
+    class->last_address_in_slab = slab + SCM_SLAB_SIZE;
+
+    return 1;
+}
+
+/**
+ * Takes a block from the free blocks of the size class or carves it
+ * from the current slab. Slabs are only allocated if neither the size class
+ * nor the orphaned blocks provide a free block.
+ */
+object_header_t* slab_malloc(size_t size) {
+
+    if (size > SCM_SLAB_MAX_OBJECT_SIZE) {
+        return NULL;
+    }
+
+    unsigned int size_class = get_size_class(size);
+
+    if (size_class >= SLAB_NUMBER_OF_CLASSES) {
+        return NULL;
+    }
+
+    slab_class_t *class = &descriptor_root->slab_classes[size_class];
+    object_header_t *object;
+
+    if (class->free_blocks == NULL &&
+            class->next_free_address + SLAB_BLOCK_SIZE(size_class) >
+            class->last_address_in_slab) {
+
+        adopt_orphaned_blocks();
+
+        if (class->free_blocks == NULL && !new_slab(class)) {
+            return NULL;
+        }
+    }
+
+    if (class->free_blocks != NULL) {
+        object = class->free_blocks;
+        class->free_blocks = NEXT_FREE_BLOCK(object);
+    } else {
+        object = class->next_free_address;
+        class->next_free_address += SLAB_BLOCK_SIZE(size_class);
+    }
+
+    init_descriptor_counter(object);
+    object->finalizer_index = -1;
+    object->allocator = OBJECT_ALLOCATOR_SLAB;
+    object->allocator_info = size_class;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_pooled_mem(SLAB_BLOCK_SIZE(size_class));
+    inc_overhead(sizeof(object_header_t));
+#endif
+
+    return object;
+}
+
+/**
+ * Pushes the block onto the free blocks of its size class. Threads without
+ * descriptor root hand the block over to the orphaned blocks.
+ */
+void slab_free(object_header_t *object) {
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_overhead(sizeof(object_header_t));
+#endif
+
+    if (descriptor_root == NULL) {
+        lock_orphaned_blocks();
+
+        NEXT_FREE_BLOCK(object) = orphaned_blocks;
+        orphaned_blocks = object;
+
+        unlock_orphaned_blocks();
+
+        return;
+    }
+
+    push_free_block(&descriptor_root->slab_classes[object->allocator_info],
+                    object);
+}
+
+size_t slab_usable_size(object_header_t *object) {
+    return SLAB_BLOCK_SIZE(object->allocator_info) - sizeof(object_header_t);
+}
+
+#endif  /* SCM_SLAB_ALLOCATION */
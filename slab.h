@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _SLAB_H_
+#define	_SLAB_H_
+
+#ifdef SCM_SLAB_ALLOCATION
+
+#include "object.h"
+#include "libscm.h"
+
+// Slab blocks are multiples of SLAB_BLOCK_ALIGNMENT bytes. The payload of
+// every slab block is aligned to SLAB_BLOCK_ALIGNMENT.
+#define SLAB_BLOCK_ALIGNMENT 16
+
+#define SLAB_NUMBER_OF_CLASSES \
+    (SCM_SLAB_MAX_OBJECT_SIZE / SLAB_BLOCK_ALIGNMENT)
+
+// The size of the blocks of size class _c including the object header
+#define SLAB_BLOCK_SIZE(_c) (((_c) + 1) * SLAB_BLOCK_ALIGNMENT)
+
+/*
+ * A size class of the thread-local slab allocator. Blocks are either
+ * taken from the list of free blocks or carved from the current slab
+ * by bumping next_free_address up to last_address_in_slab.
+ *
+ * Free blocks keep their object header, which stores the size class,
+ * and are linked through the first word of their payload.
+ */
+typedef struct slab_class slab_class_t;
+
+struct slab_class {
+    void* free_blocks;
+
+    void* next_free_address;
+    void* last_address_in_slab;
+};
+
+/*
+ * slab_malloc() returns a block of the calling thread's slabs with an
+ * initialized object header, or NULL if size exceeds the largest size
+ * class or no memory is available.
+ */
+object_header_t* slab_malloc(size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * slab_free() returns a block to the slabs of the calling thread.
+ */
+void slab_free(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/*
+ * slab_usable_size() returns the payload size of a slab block.
+ */
+size_t slab_usable_size(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+#endif  /* SCM_SLAB_ALLOCATION */
+
+#endif	/* _SLAB_H_ */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#include "descriptors.h"
+
+#ifdef SCM_HEADERLESS_OBJECTS
+
+#include <pthread.h>
+
+#if SCM_SPAN_SIZE * SCM_HEADERLESS_MAX_OBJECT_SIZE >= (1UL << 32)
+#error "SCM_SPAN_SIZE * SCM_HEADERLESS_MAX_OBJECT_SIZE must be less than 2^32"
+#endif
+
+// free blocks are linked through the first word of their payload
+#define NEXT_FREE_BLOCK(_payload) (*(void**) (_payload))
+
+#define SPAN_FIRST_BLOCK_ALIGNMENT 64
+
+arena_t span_arena = ARENA_INITIALIZER(SCM_HEADERLESS_ARENA_SIZE,
+                                       SCM_SPAN_SIZE);
+
+// Blocks that were freed by threads without a descriptor root.
+// They are adopted by the next thread that runs out of blocks.
+static void* orphaned_blocks = NULL;
+
+//protects orphaned_blocks
+static pthread_mutex_t orphaned_blocks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * lock_orphaned_blocks() locks the list of orphaned blocks.
+ */
+static inline void lock_orphaned_blocks() {
+#ifdef SCM_PRINT_BLOCKING
+    if (pthread_mutex_trylock(&orphaned_blocks_lock)) {
+        printf("Thread %p BLOCKS on span orphaned_blocks_lock.\n", (void*) pthread_self());
+        pthread_mutex_lock(&orphaned_blocks_lock);
+    }
+#else
+    pthread_mutex_lock(&orphaned_blocks_lock);
+#endif
+}
+
+/**
+ * unlock_orphaned_blocks() releases the lock of the orphaned blocks.
+ */
+static inline void unlock_orphaned_blocks() {
+    pthread_mutex_unlock(&orphaned_blocks_lock);
+}
+
+/**
+ * Returns the size class of an object with size payload bytes. The payload
+ * of a free block must be large enough to link the block.
+ */
+static inline unsigned int get_size_class(size_t size) {
+    if (size < sizeof(void*)) {
+        size = sizeof(void*);
+    }
+
+    return (size - 1) / SCM_OBJECT_ALIGNMENT;
+}
+
+static inline void push_free_block(span_class_t *class, void *payload) {
+    NEXT_FREE_BLOCK(payload) = class->free_blocks;
+    class->free_blocks = payload;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_pooled_mem(SPAN_OF(payload)->block_size);
+#endif
+}
+
+/**
+ * Moves all orphaned blocks into the size classes of the calling thread.
+ */
+static void adopt_orphaned_blocks() {
+    //unsynchronized read, we catch up with the orphans at the next refill
+    if (orphaned_blocks == NULL) {
+        return;
+    }
+
+    lock_orphaned_blocks();
+
+    void *payload = orphaned_blocks;
+    orphaned_blocks = NULL;
+
+    unlock_orphaned_blocks();
+
+    while (payload != NULL) {
+        void *next = NEXT_FREE_BLOCK(payload);
+
+        push_free_block(&descriptor_root->span_classes[SPAN_OF(payload)->size_class],
+                        payload);
+
+        payload = next;
+    }
+}
+
+/**
+ * Carves a new span for the given size class from the arena. Returns 0 iff
+ * the arena is exhausted.
+ */
+static int new_span(span_class_t *class, unsigned int size_class) {
+    span_t *span = arena_alloc(&span_arena);
+
+    if (span == NULL) {
+        return 0;
+    }
+
+    unsigned int block_size = SPAN_BLOCK_SIZE(size_class);
+
+    unsigned long number_of_blocks =
+        (SCM_SPAN_SIZE - sizeof(span_t) - SPAN_FIRST_BLOCK_ALIGNMENT)
+        / (block_size + SPAN_SIDE_ENTRY_SIZE);
+
+    span->finalizers = (short*) &span->counters[number_of_blocks];
+
+    unsigned long first_block = ((unsigned long) &span->finalizers[number_of_blocks]
+        + SPAN_FIRST_BLOCK_ALIGNMENT - 1)
+        & ~(unsigned long) (SPAN_FIRST_BLOCK_ALIGNMENT - 1);
+
+    span->size_class = size_class;
+    span->block_size = block_size;
+    span->reciprocal = ((1UL << 32) + block_size - 1) / block_size;
+    span->first_block = (void*) first_block;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    inc_allocated_mem(SCM_SPAN_SIZE);
+    inc_pooled_mem(number_of_blocks * block_size);
+#endif
+
+    class->next_free_address = span->first_block;
+    class->last_address_in_span =
+        span->first_block + number_of_blocks * block_size;
+
+    return 1;
+}
+
+/**
+ * Takes a block from the free blocks of the size class or carves it
+ * from the current span. Spans are only carved from the arena if neither
+ * the size class nor the orphaned blocks provide a free block.
+ */
+object_header_t* span_malloc(size_t size) {
+
+    if (size > SCM_HEADERLESS_MAX_OBJECT_SIZE) {
+        return NULL;
+    }
+
+    unsigned int size_class = get_size_class(size);
+    span_class_t *class = &descriptor_root->span_classes[size_class];
+    void *payload;
+
+    if (class->free_blocks == NULL &&
+            class->next_free_address + SPAN_BLOCK_SIZE(size_class) >
+            class->last_address_in_span) {
+
+        adopt_orphaned_blocks();
+
+        if (class->free_blocks == NULL && !new_span(class, size_class)) {
+            return NULL;
+        }
+    }
+
+    if (class->free_blocks != NULL) {
+        payload = class->free_blocks;
+        class->free_blocks = NEXT_FREE_BLOCK(payload);
+    } else {
+        payload = class->next_free_address;
+        class->next_free_address += SPAN_BLOCK_SIZE(size_class);
+    }
+
+    object_header_t *object = span_object_header(payload);
+
+    init_descriptor_counter(object);
+    *span_object_finalizer(object) = -1;
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_pooled_mem(SPAN_BLOCK_SIZE(size_class));
+    inc_overhead(SPAN_SIDE_ENTRY_SIZE);
+#endif
+
+    return object;
+}
+
+/**
+ * Pushes the block onto the free blocks of its size class. Threads without
+ * descriptor root hand the block over to the orphaned blocks.
+ */
+void span_free(object_header_t *object) {
+    void *payload = span_object_payload(object);
+
+#ifdef SCM_RECORD_MEMORY_USAGE
+    dec_overhead(SPAN_SIDE_ENTRY_SIZE);
+#endif
+
+    if (descriptor_root == NULL) {
+        lock_orphaned_blocks();
+
+        NEXT_FREE_BLOCK(payload) = orphaned_blocks;
+        orphaned_blocks = payload;
+
+        unlock_orphaned_blocks();
+
+        return;
+    }
+
+    push_free_block(&descriptor_root->span_classes[SPAN_OF(object)->size_class],
+                    payload);
+}
+
+size_t span_usable_size(object_header_t *object) {
+    return SPAN_OF(object)->block_size;
+}
+
+#endif  /* SCM_HEADERLESS_OBJECTS */
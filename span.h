@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2010, the Short-term Memory Project Authors.
+ * All rights reserved. Please see the AUTHORS file for details.
+ * Use of this source code is governed by a BSD license that
+ * can be found in the LICENSE file.
+ */
+
+#ifndef _SPAN_H_
+#define	_SPAN_H_
+
+#ifdef SCM_HEADERLESS_OBJECTS
+
+#include "object.h"
+#include "arena.h"
+#include "libscm.h"
+
+/*
+ * Headerless objects are allocated from spans of SCM_SPAN_SIZE bytes that
+ * are aligned to SCM_SPAN_SIZE within a reserved arena. A span keeps the
+ * descriptor counters and finalizer indexes of its blocks in two side
+ * arrays at the beginning of the span, so the payloads of the blocks are
+ * packed densely without headers and each block costs 6 bytes of metadata.
+ *
+ * -------------------------  <- pointer to span_t (SCM_SPAN_SIZE-aligned)
+ * | size class            |
+ * | block size            |
+ * | reciprocal            |
+ * | first block           |
+ * | finalizers            |
+ * | counters[0]           |
+ * ~ ...                   ~
+ * | counters[n - 1]       |
+ * -------------------------  <- finalizers
+ * | finalizers[0]         |
+ * ~ ...                   ~
+ * | finalizers[n - 1]     |
+ * -------------------------  <- first block (cache-line-aligned)
+ * | block 0               |
+ * ~ ...                   ~
+ * | block n - 1           |
+ * -------------------------
+ *
+ * The span of an object is found by masking its address. The object header
+ * of block i points to counters[i] and only its dc_or_region_id field is
+ * valid. The allocator of the block is implied by the span, its size class
+ * is the size class of the span and its finalizer index is finalizers[i].
+ */
+typedef struct span span_t;
+
+struct span {
+    unsigned int size_class;
+    unsigned int block_size;
+
+    // ceil(2^32 / block_size), replaces the division by block_size when
+    // computing the index of a block
+    unsigned long reciprocal;
+
+    void* first_block;
+
+    short* finalizers;
+
+    int counters[];
+};
+
+// the side entries of a block: its descriptor counter and finalizer index
+#define SPAN_SIDE_ENTRY_SIZE (sizeof(int) + sizeof(short))
+
+// Headerless blocks are multiples of SCM_OBJECT_ALIGNMENT bytes
+#define SPAN_NUMBER_OF_CLASSES \
+    (SCM_HEADERLESS_MAX_OBJECT_SIZE / SCM_OBJECT_ALIGNMENT)
+
+#define SPAN_BLOCK_SIZE(_c) (((_c) + 1) * SCM_OBJECT_ALIGNMENT)
+
+#define SPAN_OF(_ptr) ((span_t*) ARENA_UNIT_OF(_ptr, SCM_SPAN_SIZE))
+
+/*
+ * A size class of the headerless allocator. Blocks are either taken from
+ * the list of free blocks, which are linked through their first word, or
+ * carved from the current span by bumping next_free_address up to
+ * last_address_in_span.
+ */
+typedef struct span_class span_class_t;
+
+struct span_class {
+    void* free_blocks;
+
+    void* next_free_address;
+    void* last_address_in_span;
+};
+
+// the arena that holds all spans
+extern arena_t span_arena __attribute__((visibility("hidden")));
+
+/*
+ * is_headerless() returns true iff ptr points into a span.
+ */
+static inline int is_headerless(const void *ptr) {
+    return arena_contains(&span_arena, ptr);
+}
+
+/*
+ * Returns the side header of the block that holds payload ptr, which is
+ * its descriptor counter.
+ */
+static inline object_header_t* span_object_header(const void *ptr) {
+    span_t *span = SPAN_OF(ptr);
+
+    unsigned long index = ((unsigned long) (ptr - span->first_block)
+        * span->reciprocal) >> 32;
+
+    return (object_header_t*) &span->counters[index];
+}
+
+/*
+ * Returns the payload of the block with side header object.
+ */
+static inline void* span_object_payload(object_header_t *object) {
+    span_t *span = SPAN_OF(object);
+
+    return span->first_block
+        + (unsigned long) ((int*) object - span->counters) * span->block_size;
+}
+
+/*
+ * Returns the finalizer index of the block with side header object.
+ */
+static inline short* span_object_finalizer(object_header_t *object) {
+    span_t *span = SPAN_OF(object);
+
+    return &span->finalizers[(int*) object - span->counters];
+}
+
+/*
+ * span_malloc() returns the side header of a block of the calling thread's
+ * spans, or NULL if size exceeds SCM_HEADERLESS_MAX_OBJECT_SIZE or the
+ * arena is exhausted.
+ */
+object_header_t* span_malloc(size_t size)
+    __attribute__((visibility("hidden")));
+
+/*
+ * span_free() returns a block to the spans of the calling thread.
+ */
+void span_free(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+/*
+ * span_usable_size() returns the payload size of a headerless block.
+ */
+size_t span_usable_size(object_header_t *object)
+    __attribute__((visibility("hidden")));
+
+#endif  /* SCM_HEADERLESS_OBJECTS */
+
+#endif	/* _SPAN_H_ */